@@ -0,0 +1,309 @@
+#pragma once
+#include "Match.cpp"
+#include "Tree.cpp"
+
+#ifdef __linux__
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+#include <ctime>
+
+// Walks a directory tree for the files that match a GlobSet and remembers, per
+// directory, which entries matched. The results live in a file that later runs
+// map back in, so a directory whose inode, mtime and ctime have not changed
+// since is answered from its bitmap instead of matching its entries again.
+// Paths are relative to the root.
+//
+// A cache written for different rules is ignored as a whole. A directory's
+// mtime changes whenever an entry is added, removed or renamed in it, which is
+// all a match depends on. Tools can set the mtime back, but not the ctime, so
+// both are compared. Directories changed too recently to tell a later change
+// apart by their timestamps are not saved.
+struct MatchCache
+{
+    struct WalkStats
+    {
+        size_t reused = 0;  // directories answered from the cache
+        size_t scanned = 0; // directories whose entries were matched
+    };
+
+    // Directories changed less than `settle` milliseconds before a walk are
+    // left out of the file. The default covers filesystems that only keep
+    // timestamps to the second.
+    MatchCache(const std::string& file, const std::vector<std::string>& patterns, unsigned settle = 2000)
+        : file(file), rules(patterns), fingerprint(rules.Fingerprint()), settle((int64_t)settle * 1000000)
+    {
+        Load();
+    }
+
+    ~MatchCache() { Unmap(); }
+
+    MatchCache(const MatchCache&) = delete;
+    MatchCache& operator=(const MatchCache&) = delete;
+
+    // The matching files below `root`, in sorted order.
+    std::vector<std::string> Walk(const std::string& root)
+    {
+        tree.root = root;
+        timespec now;
+        clock_gettime(CLOCK_REALTIME, &now);
+        started = Nanoseconds(now);
+        seen.clear();
+        stats = WalkStats();
+
+        std::vector<std::string> matched;
+        Visit("", matched);
+        return matched;
+    }
+
+    const WalkStats& Stats() const { return stats; }
+
+    // Replaces the cache file with what the last Walk saw, so directories no
+    // longer visited drop out of it.
+    void Save()
+    {
+        std::sort(seen.begin(), seen.end(), [](const Directory& a, const Directory& b)
+        {
+            return a.record.hash < b.record.hash;
+        });
+
+        Header header{};
+        std::memcpy(header.magic, Magic(), sizeof header.magic);
+        header.version = version;
+        header.count = (uint32_t)seen.size();
+        header.fingerprint = fingerprint;
+
+        // records, then bitmaps, then path text, which keeps every bitmap word
+        // aligned in the mapping
+        uint64_t offset = sizeof(Header) + seen.size() * sizeof(Record);
+        for (auto& directory : seen)
+        {
+            directory.record.bits = offset;
+            offset += directory.bits.size() * sizeof(uint64_t);
+        }
+        for (auto& directory : seen)
+        {
+            directory.record.path = offset;
+            offset += directory.path.length();
+        }
+        header.size = offset;
+
+        std::string contents;
+        contents.reserve(offset);
+        contents.append((const char*)&header, sizeof header);
+        for (auto& directory : seen)
+            contents.append((const char*)&directory.record, sizeof(Record));
+        for (auto& directory : seen)
+            contents.append((const char*)directory.bits.data(), directory.bits.size() * sizeof(uint64_t));
+        for (auto& directory : seen)
+            contents.append(directory.path);
+
+        // a name of its own, so processes saving at the same time cannot
+        // interleave their writes
+        std::string temporary = file + ".XXXXXX";
+        int fd = mkstemp(&temporary[0]);
+        if (fd < 0)
+            throw std::runtime_error("mkstemp " + temporary + ": " + std::string(std::strerror(errno)));
+
+        bool written = fchmod(fd, 0644) == 0 && Write(fd, contents);
+        if (close(fd) != 0) written = false;
+
+        // readers either see the old cache or the new one, never a torn file
+        if (!written || std::rename(temporary.c_str(), file.c_str()) != 0)
+        {
+            std::string reason = std::strerror(errno);
+            unlink(temporary.c_str());
+            throw std::runtime_error("cannot write " + file + ": " + reason);
+        }
+
+        Unmap();
+        Load();
+    }
+
+private:
+    static const char* Magic() { return "GLOBCACH"; }
+    static const uint32_t version = 2;
+
+    struct Header
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t count;       // directories
+        uint64_t fingerprint; // GlobSet::Fingerprint of the rules
+        uint64_t size;        // of the whole file, catches truncation
+    };
+
+    struct Record
+    {
+        uint64_t hash;        // of the path, records are sorted by it
+        uint64_t dev;
+        uint64_t ino;
+        int64_t seconds;      // mtime
+        int64_t nanoseconds;
+        int64_t changed;      // ctime
+        int64_t changedNanoseconds;
+        uint32_t entries;
+        uint32_t length;      // of the path
+        uint64_t path;        // file offset of the path text
+        uint64_t bits;        // file offset of one bit per entry, sorted by name
+    };
+
+    struct Directory
+    {
+        std::string path;
+        Record record;
+        std::vector<uint64_t> bits;
+    };
+
+    static int64_t Nanoseconds(const timespec& time)
+    {
+        return (int64_t)time.tv_sec * 1000000000 + time.tv_nsec;
+    }
+
+    static bool Write(int fd, const std::string& contents)
+    {
+        for (size_t done = 0; done < contents.length();)
+        {
+            ssize_t count = write(fd, contents.data() + done, contents.length() - done);
+            if (count < 0 && errno == EINTR) continue;
+            if (count <= 0) return false;
+            done += count;
+        }
+
+        return true;
+    }
+
+    void Load()
+    {
+        int fd = open(file.c_str(), O_RDONLY | O_CLOEXEC);
+        if (fd < 0) return;
+
+        struct stat st;
+        if (fstat(fd, &st) == 0 && (size_t)st.st_size >= sizeof(Header))
+        {
+            void* mapping = mmap(nullptr, st.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapping != MAP_FAILED)
+            {
+                data = (const char*)mapping;
+                size = st.st_size;
+            }
+        }
+        close(fd);
+
+        if (!data) return;
+        auto header = (const Header*)data;
+        // anything written by another version or for other rules is useless
+        if (std::memcmp(header->magic, Magic(), sizeof header->magic) != 0 || header->version != version
+            || header->fingerprint != fingerprint || header->size != size
+            || header->count > (size - sizeof(Header)) / sizeof(Record))
+        {
+            Unmap();
+            return;
+        }
+
+        records = (const Record*)(data + sizeof(Header));
+        count = header->count;
+    }
+
+    void Unmap()
+    {
+        if (data) munmap((void*)data, size);
+        data = nullptr;
+        records = nullptr;
+        size = count = 0;
+    }
+
+    // The bitmap stored for a directory with exactly this key, if any.
+    const uint64_t* Find(const std::string& dir, const Record& key) const
+    {
+        auto begin = records, end = records + count;
+        auto it = std::lower_bound(begin, end, key.hash, [](const Record& r, uint64_t hash) { return r.hash < hash; });
+        for (; it != end && it->hash == key.hash; ++it)
+        {
+            uint64_t words = ((uint64_t)it->entries + 63) / 64;
+            if (it->path > size || it->length > size - it->path
+                || it->bits > size || words > (size - it->bits) / sizeof(uint64_t) || it->bits % sizeof(uint64_t))
+                return nullptr;
+
+            if (it->length == dir.length() && std::memcmp(data + it->path, dir.data(), dir.length()) == 0)
+            {
+                bool same = it->dev == key.dev && it->ino == key.ino && it->seconds == key.seconds
+                    && it->nanoseconds == key.nanoseconds && it->changed == key.changed
+                    && it->changedNanoseconds == key.changedNanoseconds && it->entries == key.entries;
+                return same ? (const uint64_t*)(data + it->bits) : nullptr;
+            }
+        }
+
+        return nullptr;
+    }
+
+    void Visit(const std::string& dir, std::vector<std::string>& matched)
+    {
+        if (!rules.MayMatchBelow(dir)) return;
+
+        struct stat st;
+        if (lstat(tree.Absolute(dir).c_str(), &st) != 0) return;
+
+        std::vector<std::pair<std::string, bool>> entries;
+        if (!tree.List(dir, entries)) return;
+        std::sort(entries.begin(), entries.end());
+
+        Directory directory;
+        directory.path = dir;
+        directory.record = Record{};
+        directory.record.hash = GlobSet::StableHash(dir);
+        directory.record.dev = st.st_dev;
+        directory.record.ino = st.st_ino;
+        directory.record.seconds = st.st_mtim.tv_sec;
+        directory.record.nanoseconds = st.st_mtim.tv_nsec;
+        directory.record.changed = st.st_ctim.tv_sec;
+        directory.record.changedNanoseconds = st.st_ctim.tv_nsec;
+        directory.record.entries = (uint32_t)entries.size();
+        directory.record.length = (uint32_t)dir.length();
+        directory.bits.assign((entries.size() + 63) / 64, 0);
+
+        if (const uint64_t* bits = Find(dir, directory.record))
+        {
+            std::copy(bits, bits + directory.bits.size(), directory.bits.begin());
+            stats.reused++;
+        }
+        else
+        {
+            for (size_t i = 0; i < entries.size(); i++)
+                if (!entries[i].second && rules.Matches(Tree::Join(dir, entries[i].first)))
+                    directory.bits[i / 64] |= (uint64_t)1 << (i % 64);
+            stats.scanned++;
+        }
+
+        // a change within the same timestamp tick would go unnoticed next time
+        if (std::max(Nanoseconds(st.st_mtim), Nanoseconds(st.st_ctim)) + settle <= started)
+            seen.push_back(directory);
+
+        for (size_t i = 0; i < entries.size(); i++)
+        {
+            std::string path = Tree::Join(dir, entries[i].first);
+            if (directory.bits[i / 64] >> (i % 64) & 1) matched.push_back(path);
+            else if (entries[i].second) Visit(path, matched);
+        }
+    }
+
+    std::string file;
+    Tree tree;
+    GlobSet rules;
+    uint64_t fingerprint;
+    int64_t settle;       // nanoseconds
+
+    const char* data = nullptr;
+    size_t size = 0;
+    const Record* records = nullptr;
+    size_t count = 0;
+
+    int64_t started = 0;  // nanoseconds since the epoch
+    std::vector<Directory> seen;
+    WalkStats stats;
+};
+#endif
@@ -1,13 +1,286 @@
+#pragma once
 #include <boost/algorithm/string.hpp>
 #include <boost/optional.hpp>
+#include <cstring>
 #include <iomanip>
 #include <sstream>
 #include <regex>
+#include <set>
 #include <stack>
+#include <atomic>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_map>
+#include <unordered_set>
+
+// A path split, measured and hashed once so that it can be tested against any
+// number of Glob or GlobSet objects without being re-tokenized for each.
+struct PathView
+{
+    PathView(const std::string& path) : path(path)
+    {
+        boost::split(parts, path, boost::is_any_of("/"));
+
+        // no slice is longer than the path, so matching never grows the table
+        Power(path.length());
+        rolling.resize(path.length() + 1);
+        rolling[0] = 0;
+        for (size_t i = 0; i < path.length(); i++)
+            rolling[i + 1] = rolling[i] * multiplier + (unsigned char)path[i];
+
+        size_t offset = 0;
+        firstHidden = parts.size();
+        for (size_t i = 0; i < parts.size(); i++)
+        {
+            offsets.push_back(offset);
+            hashes.push_back(Hash(offset, offset + parts[i].length()));
+            offset += parts[i].length() + 1;
+            hidden.push_back(!parts[i].empty() && parts[i][0] == '.');
+            if (hidden.back() && firstHidden == parts.size()) firstHidden = i;
+        }
+
+        // a single trailing slash does not start another name
+        bool slash = parts.size() > 1 && parts.back().empty();
+        name = parts.size() - (slash ? 2 : 1);
+        end = path.length() - (slash ? 1 : 0);
+    }
+
+    // Hash of path[begin, end), equal to Hash of the same text as a string,
+    // so any slice of the path can be looked up without copying it.
+    uint64_t Hash(size_t begin, size_t end) const
+    {
+        return rolling[end] - rolling[begin] * Power(end - begin);
+    }
+
+    static uint64_t Hash(const std::string& text)
+    {
+        uint64_t hash = 0;
+        for (unsigned char c : text) hash = hash * multiplier + c;
+        return hash;
+    }
+
+    std::string path;
+    std::vector<std::string> parts;
+    std::vector<size_t> offsets;      // where each segment starts in path
+    std::vector<uint64_t> hashes;     // Hash of each segment
+    std::vector<bool> hidden;         // whether each segment starts with a dot
+    size_t firstHidden;               // first hidden segment, or parts.size()
+    size_t name;                      // segment holding the basename
+    size_t end;                       // end of the basename in path
+
+private:
+    static const uint64_t multiplier = 1099511628211ull;
+
+    // multiplier to the power of `length`. The table is shared by every view
+    // and grows to the longest slice hashed so far; there is one per thread,
+    // so growing it takes no lock.
+    static uint64_t Power(size_t length)
+    {
+        static thread_local std::vector<uint64_t> powers{ 1 };
+        while (powers.size() <= length) powers.push_back(powers.back() * multiplier);
+        return powers[length];
+    }
+
+    std::vector<uint64_t> rolling;    // Hash of each prefix of path
+};
+
+// Epoch-based reclamation for Published. A reader announces the epoch it
+// started in, and a writer frees what it replaced once every reader that
+// started before the replacement has finished. Announcing is a plain store,
+// so readers never wait on writers.
+struct Epochs
+{
+    // One per thread, handed to another thread once its owner exits.
+    struct Record
+    {
+        std::atomic<uint64_t> epoch;  // 0 while the owner is not reading
+        std::atomic<bool> taken;
+        Record* next;
+        size_t depth;                 // nested reads, owner only
+        char padding[64];             // keeps records off each other's cache lines
+    };
+
+    static Epochs& Domain()
+    {
+        static Epochs domain;
+        return domain;
+    }
+
+    // The calling thread's record.
+    static Record& Local()
+    {
+        struct Owner
+        {
+            Record* record = Domain().Acquire();
+            ~Owner() { record->taken.store(false); }
+        };
+
+        static thread_local Owner owner;
+        return *owner.record;
+    }
+
+    void Enter(Record& record)
+    {
+        // only the outermost read announces, nested ones are covered by it
+        if (record.depth++ == 0) record.epoch.store(epoch.load());
+    }
+
+    void Leave(Record& record)
+    {
+        if (--record.depth == 0) record.epoch.store(0, std::memory_order_release);
+    }
+
+    // Starts a new epoch and returns it. Whatever was unpublished before the
+    // call can be freed once Oldest() is at least the returned epoch.
+    uint64_t Advance() { return epoch.fetch_add(1) + 1; }
+
+    // The epoch the longest running read started in.
+    uint64_t Oldest() const
+    {
+        uint64_t oldest = UINT64_MAX;
+        for (Record* record = records.load(); record; record = record->next)
+        {
+            uint64_t started = record->epoch.load();
+            if (started && started < oldest) oldest = started;
+        }
+
+        return oldest;
+    }
+
+private:
+    Epochs() : epoch(1), records(nullptr) {}
+
+    Record* Acquire()
+    {
+        for (Record* record = records.load(); record; record = record->next)
+            if (!record->taken.load() && !record->taken.exchange(true)) return record;
+
+        // records are never freed, there are at most as many as threads
+        // that were ever reading at the same time
+        Record* record = new Record();
+        record->epoch = 0;
+        record->taken = true;
+        record->depth = 0;
+        record->next = records.load();
+        while (!records.compare_exchange_weak(record->next, record));
+        return record;
+    }
+
+    std::atomic<uint64_t> epoch;
+    std::atomic<Record*> records;
+};
+
+// Holds the current version of something that is replaced while other threads
+// use it, such as a GlobSet reloaded from configuration. Reads never lock or
+// wait on a reload, and a replaced version is freed once the reads that could
+// still see it have finished.
+template <class T>
+struct Published
+{
+    // Keeps the version it was taken from alive. Meant to be short lived,
+    // since replaced versions wait on it.
+    class Guard
+    {
+    public:
+        Guard(Guard&& other) : record(other.record), value(other.value)
+        {
+            other.record = nullptr;
+        }
+
+        ~Guard()
+        {
+            if (record) Epochs::Domain().Leave(*record);
+        }
+
+        Guard(const Guard&) = delete;
+        Guard& operator=(const Guard&) = delete;
+
+        T* operator->() const { return value; }
+        T& operator*() const { return *value; }
+
+    private:
+        Guard(Epochs::Record& record, T* value) : record(&record), value(value) {}
+
+        Epochs::Record* record;
+        T* value;
+
+        friend struct Published;
+    };
+
+    Published(std::unique_ptr<T> value) : current(value.release()) {}
+
+    // Nothing may be reading any more.
+    ~Published()
+    {
+        delete current.load();
+    }
+
+    Published(const Published&) = delete;
+    Published& operator=(const Published&) = delete;
+
+    Guard Read()
+    {
+        Epochs::Record& record = Epochs::Local();
+        Epochs::Domain().Enter(record);
+        return Guard(record, current.load());
+    }
+
+    template <class Path>
+    bool Matches(const Path& file)
+    {
+        return Read()->Matches(file);
+    }
+
+    // Swaps in a new version. Build it before calling, readers only ever see
+    // a pointer change. Returns how many replaced versions are still waiting
+    // on readers.
+    size_t Publish(std::unique_ptr<T> value)
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        std::unique_ptr<T> old(current.exchange(value.release()));
+        retired.push_back(Retired{ Epochs::Domain().Advance(), std::move(old) });
+        return Collect();
+    }
+
+    // Frees the replaced versions no reader can still see and returns how
+    // many are left. Publish does this as well.
+    size_t Reclaim()
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        return Collect();
+    }
+
+private:
+    struct Retired
+    {
+        uint64_t epoch;
+        std::unique_ptr<T> value;
+    };
+
+    size_t Collect()
+    {
+        uint64_t oldest = Epochs::Domain().Oldest();
+        retired.erase(std::remove_if(retired.begin(), retired.end(),
+            [&](const Retired& r) { return r.epoch <= oldest; }), retired.end());
+        return retired.size();
+    }
+
+    std::atomic<T*> current;
+    std::mutex mutex;
+    std::vector<Retired> retired;
+};
 
 struct Glob
 {
-    Glob(const std::string& pattern)
+    Glob(const std::string& pattern) : Glob(pattern, true) {}
+
+private:
+    // GlobSet pools the alternatives of its rules and builds the index, trie
+    // and prefilters for the pooled set, so it skips them per rule.
+    Glob(const std::string& pattern, bool lookups)
     {
         // normalise slashes
         static const std::regex slashSplit{ "/+" };
@@ -23,11 +296,22 @@ struct Glob
         {
             std::vector<std::string> parts;
             boost::split(parts, p, boost::is_any_of("/"));
+            stats.normalized += Normalize(parts);
             globParts.push_back(parts);
         }
 
+        // parts never hold a slash, so the joined alternative is a unique key
+        std::unordered_set<std::string> seen;
         for (std::vector<std::string>& globPart : globParts)
         {
+            // identical alternatives (e.g. {a,a}) only cost another MatchOne
+            std::string key = boost::join(globPart, "/");
+            if (seen.count(key))
+            {
+                stats.duplicates++;
+                continue;
+            }
+
             std::vector<ParseItem*> buffer;
             for (std::string& part : globPart)
                 if (auto parsed = Parse(part, false))
@@ -35,13 +319,34 @@ struct Glob
                 else goto failure;
 
             set.push_back(buffer);
+            setParts.push_back(globPart);
+            seen.insert(std::move(key));
             continue;
         failure:
             // something broke, ignore this glob
             continue;
         }
+
+        stats.subsumed += Eliminate(set, setParts);
+        if (!lookups) return;
+
+        filters = Prefilters(set, setParts);
+        sequential = trie.Build(set, setParts, filters, index.Build(set, setParts));
     }
 
+public:
+    struct OptimizeStats
+    {
+        size_t normalized = 0; // segments rewritten into canonical form
+        size_t duplicates = 0; // alternatives identical to an earlier one
+        size_t subsumed = 0;   // alternatives covered by a more general one
+
+        size_t Removed() const { return duplicates + subsumed; }
+    };
+
+    const OptimizeStats& Stats() const { return stats; }
+    bool Negated() const { return negate; }
+
     void ParseNegate()
     {
         auto it = pattern.begin();
@@ -195,34 +500,571 @@ struct Glob
     protected:
         std::string m_source;
 
-    public:
-        std::string source() const { return m_source; };
-        virtual bool match(const std::string& input) = 0;
-    };
+    public:
+        const std::string& source() const { return m_source; };
+        virtual bool match(const std::string& input) = 0;
+    };
+
+    class LiteralItem : public ParseItem
+    {
+    public:
+        LiteralItem(const std::string& src) { m_source = src; };
+        bool match(const std::string& input) override { return input == m_source; };
+    };
+
+    class MagicItem : public ParseItem
+    {
+    protected:
+        std::regex regex;
+
+    public:
+        MagicItem(const std::string& src)
+        {
+            m_source = src;
+            regex = std::regex{ "^" + src + "$" };
+        };
+        bool match(const std::string& input) override
+        {
+            return std::regex_match(input, regex);
+        };
+    };
+
+    // Whether a parsed segment only matches its own text.
+    static bool IsLiteral(ParseItem* item)
+    {
+        return dynamic_cast<LiteralItem*>(item) && item->source() != "**";
+    }
+
+    // Answers alternatives that are (almost) entirely literal with hash
+    // lookups instead of one MatchOne each: exact paths, `dir/*.ext`,
+    // `**/name` and `**/*.ext`. Every lookup is driven by a single pass over
+    // the path.
+    class LiteralIndex
+    {
+    public:
+        // Indexes what it can and returns the alternatives that still need
+        // MatchOne. A lone literal alternative gains nothing from a table, so
+        // indexing only starts at two.
+        std::vector<size_t> Build(const std::vector<std::vector<ParseItem*>>& set,
+            const std::vector<std::vector<std::string>>& parts)
+        {
+            std::vector<size_t> rest, indexed;
+            for (size_t i = 0; i < set.size(); i++)
+                (Indexable(set[i], parts[i]) ? indexed : rest).push_back(i);
+
+            if (indexed.size() < 2)
+            {
+                for (size_t i : indexed) rest.push_back(i);
+                std::sort(rest.begin(), rest.end());
+                return rest;
+            }
+
+            for (size_t i : indexed)
+                Add(set[i], parts[i]);
+
+            return rest;
+        }
+
+        bool Empty() const { return size == 0; }
+        size_t Size() const { return size; }
+
+        // Every lookup hashes a slice of the path through the view, so
+        // nothing is copied or hashed again per pattern.
+        bool Matches(const PathView& view) const
+        {
+            if (!size) return false;
+
+            if (Contains(paths, view, 0, view.path.length())) return true;
+            // a pattern matches its path with one trailing slash too
+            if (view.end != view.path.length() && Contains(paths, view, 0, view.end))
+                return true;
+
+            size_t base = view.offsets[view.name];
+            if (!dirs.empty())
+            {
+                auto range = dirs.equal_range(view.Hash(0, base));
+                for (auto it = range.first; it != range.second; ++it)
+                    if (Equal(view, 0, base, it->second.first))
+                    {
+                        if (it->second.second.Matches(view, base, view.end)) return true;
+                        break;
+                    }
+            }
+
+            if (names.empty() && anywhere.Empty()) return false;
+
+            // `**` does not descend into dot directories
+            if (view.firstHidden < view.name) return false;
+
+            auto range = names.equal_range(view.hashes[view.name]);
+            for (auto it = range.first; it != range.second; ++it)
+                if (it->second == view.parts[view.name]) return true;
+
+            return anywhere.Matches(view, base, view.end);
+        }
+
+    private:
+        // Strings keyed by PathView::Hash.
+        typedef std::unordered_multimap<uint64_t, std::string> Strings;
+
+        static bool Equal(const PathView& view, size_t begin, size_t end, const std::string& text)
+        {
+            return view.path.compare(begin, end - begin, text) == 0;
+        }
+
+        static bool Contains(const Strings& strings, const PathView& view, size_t begin, size_t end)
+        {
+            auto range = strings.equal_range(view.Hash(begin, end));
+            for (auto it = range.first; it != range.second; ++it)
+                if (Equal(view, begin, end, it->second)) return true;
+            return false;
+        }
+
+        static void Insert(Strings& strings, const std::string& text)
+        {
+            uint64_t hash = PathView::Hash(text);
+            auto range = strings.equal_range(hash);
+            for (auto it = range.first; it != range.second; ++it)
+                if (it->second == text) return;
+            strings.emplace(hash, text);
+        }
+
+        // Names matched by `*<suffix>`.
+        struct Suffixes
+        {
+            Strings set;
+            std::vector<size_t> lengths;
+
+            bool Empty() const { return set.empty(); }
+
+            void Add(const std::string& suffix)
+            {
+                Insert(set, suffix);
+                if (std::find(lengths.begin(), lengths.end(), suffix.length()) == lengths.end())
+                    lengths.push_back(suffix.length());
+            }
+
+            bool Matches(const PathView& view, size_t begin, size_t end) const
+            {
+                // `*` never matches a leading dot
+                if (begin == end || view.path[begin] == '.') return false;
+                for (size_t length : lengths)
+                    if (length <= end - begin && Contains(set, view, end - length, end))
+                        return true;
+                return false;
+            }
+        };
+
+        // `*` followed by characters Parse treats literally
+        static bool IsSuffix(const std::string& part)
+        {
+            return part.length() > 1 && part[0] == '*'
+                && part.find_first_of("*?[]()|+@!\\", 1) == std::string::npos;
+        }
+
+        static bool Indexable(const std::vector<ParseItem*>& items, const std::vector<std::string>& parts)
+        {
+            if (items.size() == 2 && parts[0] == "**")
+                return IsSuffix(parts[1]) || (IsLiteral(items[1]) && !items[1]->source().empty());
+
+            for (size_t i = 0; i + 1 < items.size(); i++)
+                if (!IsLiteral(items[i])) return false;
+            return IsLiteral(items.back()) || IsSuffix(parts.back());
+        }
+
+        void Add(const std::vector<ParseItem*>& items, const std::vector<std::string>& parts)
+        {
+            size++;
+            if (items.size() == 2 && parts[0] == "**")
+            {
+                if (IsSuffix(parts[1])) anywhere.Add(parts[1].substr(1));
+                else Insert(names, items[1]->source());
+                return;
+            }
+
+            std::string dir;
+            for (size_t i = 0; i + 1 < items.size(); i++)
+                dir += items[i]->source() + "/";
+
+            if (IsLiteral(items.back()))
+            {
+                Insert(paths, dir + items.back()->source());
+                return;
+            }
+
+            uint64_t hash = PathView::Hash(dir);
+            auto range = dirs.equal_range(hash);
+            auto it = range.first;
+            while (it != range.second && it->second.first != dir) ++it;
+            if (it == range.second) it = dirs.emplace(hash, std::make_pair(dir, Suffixes()));
+            it->second.second.Add(parts.back().substr(1));
+        }
+
+        size_t size = 0;
+        Strings paths;
+        // directory, keyed by PathView::Hash, to the suffixes allowed in it
+        std::unordered_multimap<uint64_t, std::pair<std::string, Suffixes>> dirs;
+        Strings names;
+        Suffixes anywhere;
+    };
+
+    // A relaxed counter that can be bumped from concurrent Matches calls and
+    // still lets its owner be copied.
+    struct Counter
+    {
+        Counter() = default;
+        Counter(const Counter& other) : value(other.value.load(std::memory_order_relaxed)) {}
+        Counter& operator=(const Counter& other)
+        {
+            value.store(other.value.load(std::memory_order_relaxed), std::memory_order_relaxed);
+            return *this;
+        }
+
+        void operator++() { value.fetch_add(1, std::memory_order_relaxed); }
+        operator size_t() const { return value.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<size_t> value{ 0 };
+    };
+
+    struct PrefilterStats
+    {
+        Counter tested;   // candidates an alternative's prefilter looked at
+        Counter rejected; // candidates it ruled out before MatchOne
+    };
+
+    const PrefilterStats& Prefiltered() const { return prefiltered; }
+
+    // Cheap necessary conditions for an alternative, checked before its
+    // regexes run: a minimum path length, a fixed basename suffix and literal
+    // runs that have to occur somewhere in the path.
+    struct Prefilter
+    {
+        size_t minLength = 0;
+        std::string suffix;
+        std::vector<std::string> literals;
+
+        bool Trivial() const { return minLength == 0 && suffix.empty() && literals.empty(); }
+
+        bool Admits(const PathView& file) const
+        {
+            const std::string& path = file.path;
+            if (path.length() < minLength) return false;
+
+            if (!suffix.empty())
+            {
+                size_t base = file.offsets[file.name];
+                if (file.end - base < suffix.length()
+                    || path.compare(file.end - suffix.length(), suffix.length(), suffix) != 0)
+                    return false;
+            }
+
+            for (auto& literal : literals)
+                if (path.find(literal) == std::string::npos) return false;
+
+            return true;
+        }
+    };
+
+    // Alternatives merged on their shared leading segments, so that large sets
+    // like hundreds of `src/...` or `vendor/**/...` rules walk the common part
+    // of a path once. Literal segments are looked up by hash and a wildcard
+    // segment is tested once per node however many alternatives continue from
+    // it. A wildcard segment only one alternative goes through keeps that
+    // alternative's prefilter, so regexes are skipped as they would be when
+    // matching one by one. Walking follows MatchOne.
+    class SegmentTrie
+    {
+    public:
+        // Below this many alternatives trying each in turn is as cheap.
+        static const size_t minimum = 8;
+
+        // Takes over the `candidates` that start with a literal segment shared
+        // with another candidate, when there are enough of them, and returns
+        // the ones left to match one by one. Nothing is merged for the others,
+        // and they match faster behind their prefilters.
+        std::vector<size_t> Build(const std::vector<std::vector<ParseItem*>>& set,
+            const std::vector<std::vector<std::string>>& parts, const std::vector<Prefilter>& filters,
+            const std::vector<size_t>& candidates)
+        {
+            auto leading = [&](size_t i) { return set[i].size() > 1 && IsLiteral(set[i][0]); };
+
+            std::unordered_map<std::string, size_t> shared;
+            for (size_t i : candidates)
+                if (leading(i)) shared[parts[i][0]]++;
+
+            std::vector<size_t> merged, rest;
+            for (size_t i : candidates)
+                (leading(i) && shared[parts[i][0]] > 1 ? merged : rest).push_back(i);
+
+            if (merged.size() < minimum) return candidates;
+
+            nodes.assign(1, Node());
+            for (size_t i : merged)
+            {
+                // an alternative Parse could not make sense of never matches
+                if (std::find(set[i].begin(), set[i].end(), nullptr) != set[i].end()) continue;
+                Add(set[i], parts[i], filters[i]);
+                size++;
+            }
+
+            return rest;
+        }
+
+        bool Empty() const { return size == 0; }
+        size_t Size() const { return size; }
+        size_t Nodes() const { return nodes.size(); }
+
+        bool Matches(const PathView& file, PrefilterStats& stats) const
+        {
+            return size && Walk(0, file, 0, stats);
+        }
+
+    private:
+        static const size_t none = (size_t)-1;
+
+        struct Edge
+        {
+            ParseItem* item;
+            size_t node;
+            Prefilter filter;       // trivial once two alternatives share the edge
+        };
+
+        struct Node
+        {
+            bool end = false;       // an alternative ends here
+            bool tail = false;      // an alternative ends in `**` here
+            size_t globstar = none; // where alternatives continue after a `**`
+            // keyed by PathView::Hash, which the view has per segment
+            std::unordered_multimap<uint64_t, std::pair<std::string, size_t>> literals;
+            std::vector<Edge> magic;
+            std::unordered_map<std::string, size_t> magicParts; // index into magic
+        };
+
+        size_t Child(size_t node, ParseItem* item, const std::string& part, const Prefilter& filter)
+        {
+            if (item->source() == "**")
+            {
+                if (nodes[node].globstar == none)
+                {
+                    nodes[node].globstar = nodes.size();
+                    nodes.push_back(Node());
+                }
+                return nodes[node].globstar;
+            }
+
+            if (dynamic_cast<LiteralItem*>(item))
+            {
+                uint64_t hash = PathView::Hash(item->source());
+                auto range = nodes[node].literals.equal_range(hash);
+                for (auto it = range.first; it != range.second; ++it)
+                    if (it->second.first == item->source()) return it->second.second;
+
+                nodes[node].literals.emplace(hash, std::make_pair(item->source(), nodes.size()));
+                nodes.push_back(Node());
+                return nodes.size() - 1;
+            }
+
+            // segments written the same way match the same names
+            auto known = nodes[node].magicParts.find(part);
+            if (known != nodes[node].magicParts.end())
+            {
+                Edge& edge = nodes[node].magic[known->second];
+                edge.filter = Prefilter();
+                return edge.node;
+            }
+
+            nodes[node].magicParts[part] = nodes[node].magic.size();
+            nodes[node].magic.push_back(Edge{ item, nodes.size(), filter });
+            nodes.push_back(Node());
+            return nodes.size() - 1;
+        }
+
+        void Add(const std::vector<ParseItem*>& items, const std::vector<std::string>& parts, const Prefilter& filter)
+        {
+            size_t node = 0;
+            for (size_t i = 0; i < items.size(); i++)
+            {
+                if (i + 1 == items.size() && items[i]->source() == "**")
+                {
+                    nodes[node].tail = true;
+                    return;
+                }
+
+                node = Child(node, items[i], parts[i], filter);
+            }
+
+            nodes[node].end = true;
+        }
+
+        bool Walk(size_t index, const PathView& file, size_t fi, PrefilterStats& stats) const
+        {
+            const Node& node = nodes[index];
+            size_t fl = file.parts.size();
+
+            // one trailing empty segment is a trailing slash
+            if (node.end && (fi == fl || (fi == fl - 1 && file.parts[fi].empty()))) return true;
+            if (fi == fl) return false;
+
+            const std::string& part = file.parts[fi];
+            auto range = node.literals.equal_range(file.hashes[fi]);
+            for (auto it = range.first; it != range.second; ++it)
+                if (it->second.first == part && Walk(it->second.second, file, fi + 1, stats)) return true;
+
+            for (auto& edge : node.magic)
+                if (Admits(edge.filter, file, stats) && edge.item->match(part)
+                    && Walk(edge.node, file, fi + 1, stats))
+                    return true;
+
+            if (node.tail)
+            {
+                size_t i = fi;
+                while (i < fl && !file.hidden[i]) i++;
+                if (i == fl) return true;
+            }
+
+            if (node.globstar != none)
+                for (size_t fr = fi; fr < fl; fr++)
+                {
+                    if (Walk(node.globstar, file, fr, stats)) return true;
+                    if (file.hidden[fr]) break;
+                }
+
+            return false;
+        }
+
+        size_t size = 0;
+        std::vector<Node> nodes;
+    };
+
+    // Works out what every path matched by an alternative must contain.
+    // Segments too irregular to reason about contribute nothing.
+    static Prefilter Require(const std::vector<std::string>& parts)
+    {
+        Prefilter filter;
+        std::vector<std::string> literals;
+        size_t segments = 0;
+
+        for (size_t i = 0; i < parts.size(); i++)
+        {
+            if (parts[i] == "**") continue;
+            segments++;
+
+            size_t length = 0;
+            bool tail = false;
+            std::vector<std::string> runs;
+            if (!Analyze(parts[i], length, runs, tail)) continue;
+
+            filter.minLength += length;
+            // a literal tail on the last segment pins the basename's end
+            if (tail && i + 1 == parts.size())
+            {
+                filter.suffix = runs.back();
+                runs.pop_back();
+            }
+
+            literals.insert(literals.end(), runs.begin(), runs.end());
+        }
+
+        if (segments) filter.minLength += segments - 1;
+
+        // longest first, and nothing already implied by a longer literal
+        std::stable_sort(literals.begin(), literals.end(),
+            [](const std::string& a, const std::string& b) { return a.length() > b.length(); });
+        for (auto& literal : literals)
+        {
+            if (filter.suffix.find(literal) != std::string::npos) continue;
+            bool implied = false;
+            for (auto& kept : filter.literals)
+                implied = implied || kept.find(literal) != std::string::npos;
+            if (!implied) filter.literals.push_back(literal);
+        }
+
+        return filter;
+    }
+
+    // Measures one segment pattern: the fewest characters a name matching it
+    // can have, the literal runs it must contain and whether the last run ends
+    // the segment. Returns false for unterminated classes or pattern lists,
+    // which Parse reinterprets, and for pattern lists holding a class.
+    static bool Analyze(const std::string& part, size_t& length, std::vector<std::string>& runs, bool& tail)
+    {
+        std::string run;
+        auto flush = [&]()
+        {
+            if (!run.empty()) runs.push_back(run);
+            run.clear();
+        };
+
+        for (size_t i = 0; i < part.length(); i++)
+        {
+            char c = part[i];
+
+            // pattern lists may match nothing at all
+            if (i + 1 < part.length() && part[i + 1] == '(' && std::strchr("?*+@!", c))
+            {
+                int depth = 0;
+                size_t j = i + 1;
+                for (; j < part.length(); j++)
+                {
+                    // a class may hide the closing parenthesis, as in
+                    // `@(a|[)])`, so leave the segment alone
+                    if (part[j] == '[') return false;
+                    if (part[j] == '\\') j++;
+                    else if (part[j] == '(') depth++;
+                    else if (part[j] == ')' && --depth == 0) break;
+                }
+
+                if (j >= part.length()) return false;
+                flush();
+                i = j;
+                continue;
+            }
+
+            switch (c)
+            {
+                case '\\':
+                    // a trailing backslash matches itself
+                    if (i + 1 < part.length()) c = part[++i];
+                    run += c;
+                    length++;
+                    continue;
+
+                case '*':
+                    flush();
+                    continue;
+
+                case '?':
+                    flush();
+                    length++;
+                    continue;
 
-    class LiteralItem : public ParseItem
-    {
-    public:
-        LiteralItem(const std::string& src) { m_source = src; };
-        bool match(const std::string& input) override { return input == m_source; };
-    };
+                case '[':
+                {
+                    size_t j = i + 1;
+                    if (j < part.length() && (part[j] == '!' || part[j] == '^')) j++;
+                    // a leading `]` belongs to the class
+                    for (j++; j < part.length() && part[j] != ']'; j++)
+                        if (part[j] == '\\') j++;
+
+                    if (j >= part.length()) return false;
+                    flush();
+                    length++;
+                    i = j;
+                    continue;
+                }
 
-    class MagicItem : public ParseItem
-    {
-    protected:
-        std::regex regex;
+                default:
+                    run += c;
+                    length++;
+                    continue;
+            }
+        }
 
-    public:
-        MagicItem(const std::string& src)
-        {
-            m_source = src;
-            regex = std::regex{ "^" + src + "$" };
-        };
-        bool match(const std::string& input) override
-        {
-            return std::regex_match(input, regex);
-        };
-    };
+        tail = !run.empty();
+        flush();
+        return true;
+    }
 
     struct PatternListEntry
     {
@@ -527,27 +1369,172 @@ struct Glob
         return std::pair<ParseItem*, bool>{new MagicItem{ re }, false};
     }
 
+    // The order alternatives are tried in, most frequently hit first. Each
+    // thread counts hits and calls in a shard of its own, and every `period`
+    // calls on a shard the shards are summed and the new order is published,
+    // so concurrent matches keep a consistent one without sharing counters.
+    class AdaptiveOrder
+    {
+    public:
+        AdaptiveOrder(const std::vector<size_t>& initial, size_t alternatives, size_t period)
+            : count(alternatives), period(period ? period : 1),
+            shardCount(std::min<size_t>(16, std::max(1u, std::thread::hardware_concurrency()))),
+            shards(new Shard[shardCount]),
+            order(std::unique_ptr<std::vector<size_t>>(new std::vector<size_t>(initial)))
+        {
+            for (size_t s = 0; s < shardCount; s++)
+                shards[s].hits.reset(new std::atomic<size_t>[alternatives]());
+        }
+
+        // Whether `test` accepts any alternative, stopping at the first.
+        template <class Test>
+        bool Any(Test test)
+        {
+            Shard& shard = shards[Slot() % shardCount];
+            bool hit = false;
+            {
+                auto current = order.Read();
+                for (size_t i : *current)
+                    if (test(i))
+                    {
+                        Bump(shard.hits[i]);
+                        hit = true;
+                        break;
+                    }
+            }
+
+            if (Bump(shard.calls) % period == 0) Reorder();
+            return hit;
+        }
+
+        std::vector<size_t> Order() { return *order.Read(); }
+
+    private:
+        struct Shard
+        {
+            std::unique_ptr<std::atomic<size_t>[]> hits;
+            std::atomic<size_t> calls{ 0 };
+            char padding[64];             // keeps shards off each other's cache lines
+        };
+
+        // Threads only share a shard once there are more of them than
+        // shards, so an occasionally lost count is cheaper than a locked add.
+        static size_t Bump(std::atomic<size_t>& counter)
+        {
+            size_t value = counter.load(std::memory_order_relaxed) + 1;
+            counter.store(value, std::memory_order_relaxed);
+            return value;
+        }
+
+        static size_t Slot()
+        {
+            static std::atomic<size_t> next{ 0 };
+            static thread_local size_t slot = next++;
+            return slot;
+        }
+
+        void Reorder()
+        {
+            std::unique_lock<std::mutex> lock(mutex, std::try_to_lock);
+            if (!lock) return; // another thread is at it already
+
+            std::vector<size_t> seen(count);
+            for (size_t s = 0; s < shardCount; s++)
+                for (size_t i = 0; i < count; i++)
+                {
+                    size_t hits = shards[s].hits[i].load(std::memory_order_relaxed);
+                    seen[i] += hits;
+                    // decay so the order follows a workload that shifts
+                    shards[s].hits[i].store(hits / 2, std::memory_order_relaxed);
+                }
+
+            std::vector<size_t> current = Order(), next = current;
+            std::stable_sort(next.begin(), next.end(), [&](size_t a, size_t b) { return seen[a] > seen[b]; });
+            if (next != current)
+                order.Publish(std::unique_ptr<std::vector<size_t>>(new std::vector<size_t>(next)));
+        }
+
+        size_t count;
+        size_t period;
+        size_t shardCount;
+        std::unique_ptr<Shard[]> shards;
+        std::mutex mutex;
+        Published<std::vector<size_t>> order;
+    };
+
+    // Opt-in: tries the alternatives most paths have matched first, which
+    // pays off for skewed workloads over sets like `src/**/*.{js,jsx,ts,tsx}`.
+    // Any matching alternative gives the same result, so only the cost
+    // changes. Alternatives the literal index or the trie answer are not
+    // involved, and copies of this Glob share the counts. With fewer than two
+    // alternatives left to order this does nothing.
+    void Adapt(size_t period = 1024)
+    {
+        if (sequential.size() > 1) adaptive = std::make_shared<AdaptiveOrder>(sequential, set.size(), period);
+    }
+
     bool Matches(const std::string& file)
     {
-        std::vector<std::string> parts;
-        boost::split(parts, file, boost::is_any_of("/"));
+        return Matches(PathView(file));
+    }
+
+    bool Matches(const PathView& file)
+    {
+        if (index.Matches(file) || trie.Matches(file, prefiltered)) return !negate;
 
-        for (auto& member : set)
-            if (this->MatchOne(parts, member, false)) return !negate;
+        auto test = [&](size_t i)
+        {
+            return Admits(filters[i], file, prefiltered) && MatchOne(file.parts, set[i], false);
+        };
+
+        if (adaptive) return adaptive->Any(test) != negate;
+        for (size_t i : sequential)
+            if (test(i)) return !negate;
 
         return negate;
     }
 
-    bool MatchOne(const std::vector<std::string>& file,
+    static bool Admits(const Prefilter& filter, const PathView& file, PrefilterStats& stats)
+    {
+        if (filter.Trivial()) return true;
+        ++stats.tested;
+        if (filter.Admits(file)) return true;
+        ++stats.rejected;
+        return false;
+    }
+
+    // Only alternatives that reach a regex are worth prefiltering.
+    static std::vector<Prefilter> Prefilters(const std::vector<std::vector<ParseItem*>>& set,
+        const std::vector<std::vector<std::string>>& parts)
+    {
+        std::vector<Prefilter> filters(set.size());
+        for (size_t i = 0; i < set.size(); i++)
+            for (auto item : set[i])
+                if (dynamic_cast<MagicItem*>(item))
+                {
+                    filters[i] = Require(parts[i]);
+                    break;
+                }
+
+        return filters;
+    }
+
+    static bool MatchOne(const std::vector<std::string>& file,
         const std::vector<ParseItem*>& pattern, bool partial)
     {
-        size_t fi = 0, pi = 0;
+        return MatchOne(file, 0, pattern, 0, partial);
+    }
+
+    // Matches file[fi..] against pattern[pi..] without copying either.
+    static bool MatchOne(const std::vector<std::string>& file, size_t fi,
+        const std::vector<ParseItem*>& pattern, size_t pi, bool partial)
+    {
         auto fl = file.size();
         auto pl = pattern.size();
 
         for (; fi < fl && pi < pl; fi++, pi++)
         {
-            auto part = file[fi];
+            const std::string& part = file[fi];
             auto item = pattern[pi];
 
             if (item == nullptr) return false;
@@ -567,9 +1554,7 @@ struct Glob
 
                 while (fr < fl)
                 {
-                    std::vector<std::string> frSlice(file.begin() + fr, file.end());
-                    std::vector<ParseItem*> prSlice(pattern.begin() + pr, pattern.end());
-                    if (MatchOne(frSlice, prSlice, partial))
+                    if (MatchOne(file, fr, pattern, pr, partial))
                         return true;
                     if (file[fr][0] == '.')
                         break;
@@ -605,10 +1590,452 @@ struct Glob
         return false;
     }
 
+    // Rewrites segments into the cheapest equivalent form: runs of `*` fold
+    // into one and consecutive `**` segments collapse. Returns the number of
+    // rewrites.
+    static size_t Normalize(std::vector<std::string>& parts)
+    {
+        size_t rewrites = 0;
+        for (size_t i = 1; i < parts.size();)
+        {
+            if (parts[i] == "**" && parts[i - 1] == "**")
+            {
+                parts.erase(parts.begin() + i);
+                rewrites++;
+            }
+            else i++;
+        }
+
+        for (std::string& part : parts)
+        {
+            if (part == "**") continue;
+
+            std::string folded;
+            for (size_t i = 0; i < part.length(); i++)
+            {
+                char c = part[i];
+                if (c == '\\' && i + 1 < part.length())
+                {
+                    folded += c;
+                    folded += part[++i];
+                    continue;
+                }
+
+                // character classes are left alone
+                if (c == '[')
+                {
+                    folded += part.substr(i);
+                    break;
+                }
+
+                if (c != '*')
+                {
+                    folded += c;
+                    continue;
+                }
+
+                size_t run = part.find_first_not_of('*', i);
+                if (run == std::string::npos) run = part.length();
+                size_t count = run - i;
+                // `**(a)` is a star followed by the `*(a)` pattern list
+                bool list = run < part.length() && part[run] == '(';
+                size_t keep = list && count > 1 ? 2 : 1;
+                folded.append(keep, '*');
+                i = run - 1;
+            }
+
+            if (folded != part)
+            {
+                part = folded;
+                rewrites++;
+            }
+        }
+
+        return rewrites;
+    }
+
+    // Whether segment pattern `a` matches every name segment pattern `b` does.
+    static bool Covers(const std::string& a, const std::string& b)
+    {
+        if (a == b) return true;
+        // `*` takes any non-empty name that does not start with a dot
+        return a == "*" && !b.empty() && b != "**" && b[0] != '.' && b[0] != '\\';
+    }
+
+    // Whether every path matched by alternative `b` is provably matched by
+    // alternative `a`. Only alternatives with at most one `**` are reasoned
+    // about; anything else is conservatively reported as not subsumed.
+    static bool Subsumes(const std::vector<std::string>& a, const std::vector<std::string>& b)
+    {
+        auto star = std::find(a.begin(), a.end(), "**");
+        if (star == a.end())
+        {
+            if (a.size() != b.size() || std::find(b.begin(), b.end(), "**") != b.end())
+                return false;
+            for (size_t i = 0; i < a.size(); i++)
+                if (!Covers(a[i], b[i])) return false;
+            return true;
+        }
+
+        if (std::find(star + 1, a.end(), "**") != a.end()) return false;
+
+        size_t prefix = std::distance(a.begin(), star);
+        size_t suffix = a.size() - prefix - 1;
+        if (b.size() < prefix + suffix) return false;
+
+        for (size_t i = 0; i < prefix; i++)
+            if (!Covers(a[i], b[i])) return false;
+        for (size_t i = 0; i < suffix; i++)
+            if (!Covers(a[prefix + 1 + i], b[b.size() - suffix + i])) return false;
+
+        // a trailing `**` needs at least one segment to consume
+        size_t middle = b.size() - prefix - suffix;
+        if (suffix == 0 && middle == 0) return false;
+
+        // whatever b matches in between must be reachable by `**`
+        for (size_t i = prefix; i < prefix + middle; i++)
+            if (b[i] != "**" && !Covers("*", b[i])) return false;
+
+        return true;
+    }
+
+    // How many chunks Parallel should split `count` items into for `threads`
+    // threads, where 0 means one per core.
+    static size_t Chunks(size_t count, unsigned threads)
+    {
+        if (threads == 0) threads = std::max(1u, std::thread::hardware_concurrency());
+        return std::max<size_t>(1, std::min<size_t>(threads, count));
+    }
+
+    // Runs work(chunk, begin, end) over [0, count) split into contiguous
+    // chunks, each on its own thread. The first exception in chunk order is
+    // rethrown once all of them are done.
+    template <class Work>
+    static void Parallel(size_t count, size_t chunks, Work work)
+    {
+        if (chunks <= 1)
+        {
+            work(0, 0, count);
+            return;
+        }
+
+        std::vector<std::exception_ptr> errors(chunks);
+        std::vector<std::thread> threads;
+        for (size_t chunk = 0; chunk < chunks; chunk++)
+            threads.emplace_back([&, chunk]
+            {
+                try
+                {
+                    work(chunk, count * chunk / chunks, count * (chunk + 1) / chunks);
+                }
+                catch (...)
+                {
+                    errors[chunk] = std::current_exception();
+                }
+            });
+
+        for (auto& thread : threads) thread.join();
+        for (auto& error : errors)
+            if (error) std::rethrow_exception(error);
+    }
+
+    // Drops alternatives that another alternative in the same set subsumes.
+    // Returns the number of alternatives removed.
+    static size_t Eliminate(std::vector<std::vector<ParseItem*>>& set,
+        std::vector<std::vector<std::string>>& parts, unsigned threads = 1)
+    {
+        // only alternatives with wildcard segments can subsume others
+        std::vector<size_t> general;
+        for (size_t i = 0; i < parts.size(); i++)
+            for (auto& part : parts[i])
+                if (part == "*" || part == "**")
+                {
+                    general.push_back(i);
+                    break;
+                }
+
+        if (general.empty()) return 0;
+
+        // Covers only lets `*` stand for something else, so every other
+        // segment of a subsuming alternative appears verbatim in the one it
+        // subsumes, at the same index from the start before its `**` or from
+        // the end after it. Keying each general alternative on its rarest such
+        // segment leaves few pairs to check in large sets.
+        typedef std::pair<long, std::string> Key; // index from the start, or negative from the end
+        auto keys = [&](size_t j)
+        {
+            std::vector<Key> keys;
+            auto& p = parts[j];
+            long star = (long)(std::find(p.begin(), p.end(), "**") - p.begin());
+            for (long k = 0; k < (long)p.size(); k++)
+                if (p[k] != "*" && p[k] != "**")
+                    keys.emplace_back(k < star ? k : k - (long)p.size(), p[k]);
+            return keys;
+        };
+
+        std::map<Key, size_t> frequency;
+        for (size_t j : general)
+            for (auto& key : keys(j)) frequency[key]++;
+
+        std::map<Key, std::vector<size_t>> keyed;
+        std::vector<size_t> unkeyed;
+        std::set<long> positions;
+        for (size_t j : general)
+        {
+            auto candidates = keys(j);
+            if (candidates.empty())
+            {
+                unkeyed.push_back(j);
+                continue;
+            }
+
+            Key rarest = candidates[0];
+            for (auto& key : candidates)
+                if (frequency[key] < frequency[rarest]) rarest = key;
+            keyed[rarest].push_back(j);
+            positions.insert(rarest.first);
+        }
+
+        // each alternative is judged on its own, so the set can be split
+        // across threads without changing what is removed; small sets, such
+        // as the groups of a rule list that keeps switching polarity, are not
+        // worth starting threads for
+        static const size_t grain = 512;
+        std::vector<char> removed(parts.size(), false);
+        Parallel(parts.size(), Chunks(parts.size() / grain, threads), [&](size_t, size_t begin, size_t end)
+        {
+            for (size_t i = begin; i < end; i++)
+            {
+                auto subsumed = [&](const std::vector<size_t>& candidates)
+                {
+                    for (size_t j : candidates)
+                    {
+                        if (i == j || !Subsumes(parts[j], parts[i])) continue;
+                        // of two equivalent alternatives keep the earlier one
+                        if (j > i && Subsumes(parts[i], parts[j])) continue;
+                        return true;
+                    }
+                    return false;
+                };
+
+                removed[i] = subsumed(unkeyed);
+                for (auto it = positions.begin(); !removed[i] && it != positions.end(); ++it)
+                {
+                    long k = *it < 0 ? *it + (long)parts[i].size() : *it;
+                    if (k < 0 || k >= (long)parts[i].size()) continue;
+                    auto bucket = keyed.find(Key(*it, parts[i][k]));
+                    if (bucket != keyed.end()) removed[i] = subsumed(bucket->second);
+                }
+            }
+        });
+
+        size_t count = 0;
+        for (size_t i = 0; i < parts.size(); i++)
+        {
+            if (removed[i])
+            {
+                count++;
+                continue;
+            }
+
+            if (count)
+            {
+                set[i - count] = std::move(set[i]);
+                parts[i - count] = std::move(parts[i]);
+            }
+        }
+
+        set.resize(set.size() - count);
+        parts.resize(parts.size() - count);
+        return count;
+    }
+
 private:
     bool negate = false;
     std::vector<std::string> globSet;
     std::vector<std::vector<std::string>> globParts;
     std::string pattern;
     std::vector<std::vector<ParseItem*>> set;
-};
\ No newline at end of file
+    std::vector<std::vector<std::string>> setParts;
+    OptimizeStats stats;
+    LiteralIndex index;
+    SegmentTrie trie;
+    std::vector<size_t> sequential;
+    std::vector<Prefilter> filters;
+    PrefilterStats prefiltered;
+    std::shared_ptr<AdaptiveOrder> adaptive;
+
+    friend struct GlobSet;
+};
+
+// An ordered rule list. A path is matched when the last rule that applies to it
+// is not negated, so a leading `!` excludes paths matched by earlier rules
+// instead of inverting the rule.
+struct GlobSet
+{
+    // Consecutive rules of the same polarity. Which rule in a group matched
+    // makes no difference, so their alternatives are pooled.
+    struct Group
+    {
+        bool negate;
+        std::vector<std::vector<Glob::ParseItem*>> set;
+        std::vector<std::vector<std::string>> parts;
+        Glob::LiteralIndex index;
+        Glob::SegmentTrie trie;
+        std::vector<size_t> sequential;
+        std::vector<Glob::Prefilter> filters;
+        std::shared_ptr<Glob::AdaptiveOrder> adaptive;
+    };
+
+    // With `threads` other than 1 the rules are parsed and optimized on that
+    // many threads, 0 meaning one per core. The result does not depend on it.
+    GlobSet(const std::vector<std::string>& patterns, unsigned threads = 1)
+    {
+        // each thread compiles a contiguous run of rules into its own arena,
+        // and the arenas are merged in rule order; starting a thread costs as
+        // much as compiling a few rules, so each gets at least a few dozen
+        static const size_t grain = 64;
+        std::vector<std::vector<Glob>> arenas(Glob::Chunks(patterns.size() / grain, threads));
+        Glob::Parallel(patterns.size(), arenas.size(), [&](size_t chunk, size_t begin, size_t end)
+        {
+            arenas[chunk].reserve(end - begin);
+            for (size_t i = begin; i < end; i++)
+                arenas[chunk].push_back(Glob(patterns[i], false));
+        });
+
+        std::unordered_set<std::string> seen;
+        for (auto& arena : arenas)
+            for (auto& glob : arena)
+            {
+                stats.normalized += glob.stats.normalized;
+                stats.duplicates += glob.stats.duplicates;
+                stats.subsumed += glob.stats.subsumed;
+
+                // consecutive rules of the same polarity form one group
+                if (groups.empty() || groups.back().negate != glob.negate)
+                {
+                    groups.push_back(Group{ glob.negate });
+                    seen.clear();
+                }
+
+                Group& group = groups.back();
+                for (size_t i = 0; i < glob.set.size(); i++)
+                {
+                    // segments never contain a slash, so joined parts are unique
+                    if (!seen.insert(boost::join(glob.setParts[i], "/")).second)
+                    {
+                        stats.duplicates++;
+                        continue;
+                    }
+
+                    group.set.push_back(std::move(glob.set[i]));
+                    group.parts.push_back(std::move(glob.setParts[i]));
+                }
+            }
+
+        // alternatives in a group are interchangeable, so one may subsume
+        // another even when they come from different rules
+        for (auto& group : groups)
+        {
+            stats.subsumed += Glob::Eliminate(group.set, group.parts, threads);
+            group.filters = Glob::Prefilters(group.set, group.parts);
+            group.sequential = group.trie.Build(group.set, group.parts, group.filters,
+                group.index.Build(group.set, group.parts));
+        }
+    }
+
+    bool Matches(const std::string& file)
+    {
+        return Matches(PathView(file));
+    }
+
+    bool Matches(const PathView& file)
+    {
+        for (size_t g = groups.size(); g-- > 0;)
+        {
+            const Group& group = groups[g];
+            if (group.index.Matches(file) || group.trie.Matches(file, prefiltered)) return !group.negate;
+
+            auto test = [&](size_t i)
+            {
+                return Glob::Admits(group.filters[i], file, prefiltered)
+                    && Glob::MatchOne(file.parts, group.set[i], false);
+            };
+
+            if (group.adaptive)
+            {
+                if (group.adaptive->Any(test)) return !group.negate;
+                continue;
+            }
+
+            for (size_t i : group.sequential)
+                if (test(i)) return !group.negate;
+        }
+
+        return false;
+    }
+
+    // Glob::Adapt for every group. Which rule applies to a path still depends
+    // on the order of the groups, so alternatives are only reordered within
+    // one, where they all give the same result.
+    void Adapt(size_t period = 1024)
+    {
+        for (auto& group : groups)
+            if (group.sequential.size() > 1)
+                group.adaptive = std::make_shared<Glob::AdaptiveOrder>(group.sequential, group.set.size(), period);
+    }
+
+    // Whether a path below directory `dir` could still be matched, so walkers
+    // can skip directories no rule reaches into. Excluding rules are ignored
+    // since a later rule may include paths again.
+    bool MayMatchBelow(const std::string& dir)
+    {
+        std::vector<std::string> parts;
+        if (!dir.empty()) boost::split(parts, dir, boost::is_any_of("/"));
+
+        for (auto& group : groups)
+            if (!group.negate)
+                for (auto& member : group.set)
+                    if (Glob::MatchOne(parts, member, true)) return true;
+
+        return false;
+    }
+
+    // A hash of the compiled rules that stays the same from run to run, for
+    // keying results persisted outside the process. Rule lists that compile
+    // to the same groups share it.
+    uint64_t Fingerprint() const
+    {
+        uint64_t hash = StableHash("");
+        auto add = [&](const std::string& text) { hash = StableHash("\xff", StableHash(text, hash)); };
+
+        for (auto& group : groups)
+        {
+            add((group.negate ? "!" : "") + std::to_string(group.parts.size()));
+            for (auto& parts : group.parts)
+                add(boost::join(parts, "/"));
+        }
+
+        return hash;
+    }
+
+    // FNV-1a of `text`, continuing from `hash`. Unlike std::hash it is the
+    // same in every build, so it can key what is written to disk.
+    static uint64_t StableHash(const std::string& text, uint64_t hash = 14695981039346656037ull)
+    {
+        for (unsigned char c : text) hash = (hash ^ c) * 1099511628211ull;
+        return hash;
+    }
+
+    const Glob::OptimizeStats& Stats() const { return stats; }
+    const Glob::PrefilterStats& Prefiltered() const { return prefiltered; }
+
+    // The compiled groups in rule order, for tools that work from the
+    // alternatives themselves, such as code generators.
+    const std::vector<Group>& Groups() const { return groups; }
+
+private:
+    std::vector<Group> groups;
+    Glob::OptimizeStats stats;
+    Glob::PrefilterStats prefiltered;
+};
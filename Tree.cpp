@@ -0,0 +1,53 @@
+#pragma once
+#include <string>
+#include <utility>
+#include <vector>
+
+#ifdef __linux__
+#include <sys/stat.h>
+#include <dirent.h>
+
+// A directory tree addressed by paths relative to its root, as GlobWatch and
+// MatchCache see it. The root itself is the empty path.
+struct Tree
+{
+    static std::string Join(const std::string& dir, const std::string& name)
+    {
+        return dir.empty() ? name : dir + "/" + name;
+    }
+
+    std::string Absolute(const std::string& path) const
+    {
+        return path.empty() ? root : root + "/" + path;
+    }
+
+    // The names in `dir` other than `.` and `..`, each with whether it is a
+    // directory, in the order the filesystem returns them. Symbolic links are
+    // not followed. Returns false if `dir` cannot be opened.
+    bool List(const std::string& dir, std::vector<std::pair<std::string, bool>>& entries) const
+    {
+        DIR* handle = opendir(Absolute(dir).c_str());
+        if (!handle) return false;
+
+        while (dirent* entry = readdir(handle))
+        {
+            std::string name = entry->d_name;
+            if (name == "." || name == "..") continue;
+
+            bool isDir = entry->d_type == DT_DIR;
+            if (entry->d_type == DT_UNKNOWN)
+            {
+                struct stat st;
+                isDir = lstat(Absolute(Join(dir, name)).c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+            }
+
+            entries.emplace_back(name, isDir);
+        }
+
+        closedir(handle);
+        return true;
+    }
+
+    std::string root;
+};
+#endif
@@ -0,0 +1,215 @@
+#pragma once
+#include "Match.cpp"
+#include "Tree.cpp"
+
+#ifdef __linux__
+#include <sys/inotify.h>
+#include <sys/stat.h>
+#include <poll.h>
+#include <unistd.h>
+#include <cerrno>
+#include <cstring>
+#include <map>
+#include <set>
+
+// Keeps the set of files below a root directory that match a GlobSet up to
+// date by following inotify events instead of re-walking the tree. Only
+// directories a rule could still reach into are watched. Paths are relative to
+// the root.
+struct GlobWatch
+{
+    struct Changes
+    {
+        std::vector<std::string> added;
+        std::vector<std::string> removed;
+    };
+
+    GlobWatch(const std::string& root, const std::vector<std::string>& patterns)
+        : tree{ root }, rules(patterns)
+    {
+        fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+        if (fd < 0)
+            throw std::runtime_error("inotify_init1: " + std::string(std::strerror(errno)));
+
+        Scan("");
+        added.clear();
+    }
+
+    ~GlobWatch() { close(fd); }
+
+    GlobWatch(const GlobWatch&) = delete;
+    GlobWatch& operator=(const GlobWatch&) = delete;
+
+    // For callers that multiplex the watch into their own event loop.
+    int Fd() const { return fd; }
+
+    const std::set<std::string>& Matched() const { return matched; }
+
+    // Waits up to `timeout` milliseconds (-1 blocks) for events, then drains
+    // everything queued and applies it as one batch. Events are coalesced per
+    // path, so the work done depends on how many paths changed and the
+    // returned changes are net of the whole batch.
+    Changes Poll(int timeout = 0)
+    {
+        pollfd p{ fd, POLLIN, 0 };
+        if (poll(&p, 1, timeout) <= 0) return Changes{};
+
+        std::set<std::string> dirty;
+        bool overflow = false;
+        alignas(inotify_event) char buffer[64 * 1024];
+
+        ssize_t length;
+        while ((length = read(fd, buffer, sizeof buffer)) > 0)
+        {
+            for (char* it = buffer; it < buffer + length;)
+            {
+                auto event = reinterpret_cast<inotify_event*>(it);
+                it += sizeof(inotify_event) + event->len;
+
+                if (event->mask & IN_Q_OVERFLOW)
+                {
+                    overflow = true;
+                    continue;
+                }
+
+                auto dir = dirs.find(event->wd);
+                if (dir == dirs.end()) continue;
+
+                if (event->len)
+                    dirty.insert(Tree::Join(dir->second, event->name));
+                else if (event->mask & (IN_DELETE_SELF | IN_MOVE_SELF))
+                    dirty.insert(dir->second);
+            }
+        }
+
+        // the kernel dropped events, only a full rescan is trustworthy
+        if (overflow)
+        {
+            dirty.clear();
+            dirty.insert("");
+        }
+
+        // paths that are gone go first: a directory renamed within the batch
+        // keeps its watch, and scanning the new name hands that watch over
+        std::vector<std::string> order(dirty.begin(), dirty.end());
+        std::stable_partition(order.begin(), order.end(), [&](const std::string& path) { return !Exists(path); });
+        for (auto& path : order)
+            Reconcile(path);
+
+        Changes changes;
+        changes.added.assign(added.begin(), added.end());
+        changes.removed.assign(removed.begin(), removed.end());
+        added.clear();
+        removed.clear();
+        return changes;
+    }
+
+private:
+    static const uint32_t mask = IN_CREATE | IN_DELETE | IN_MOVED_FROM | IN_MOVED_TO
+        | IN_DELETE_SELF | IN_MOVE_SELF | IN_ONLYDIR | IN_DONT_FOLLOW;
+
+    bool Exists(const std::string& path) const
+    {
+        struct stat st;
+        return lstat(tree.Absolute(path).c_str(), &st) == 0;
+    }
+
+    // Brings whatever is known about `path` in line with the filesystem.
+    void Reconcile(const std::string& path)
+    {
+        struct stat st;
+        bool exists = lstat(tree.Absolute(path).c_str(), &st) == 0;
+
+        if (exists && S_ISDIR(st.st_mode))
+        {
+            // a directory may have been replaced wholesale, start over
+            Forget(path);
+            Scan(path);
+            return;
+        }
+
+        if (watches.count(path)) Forget(path);
+        if (exists && !path.empty() && rules.Matches(path)) Add(path);
+        else Remove(path);
+    }
+
+    void Scan(const std::string& dir)
+    {
+        if (!rules.MayMatchBelow(dir)) return;
+
+        // watch before listing so nothing created in between is missed
+        int wd = inotify_add_watch(fd, tree.Absolute(dir).c_str(), mask);
+        if (wd < 0) return;
+        dirs[wd] = dir;
+        watches[dir] = wd;
+
+        std::vector<std::pair<std::string, bool>> entries;
+        tree.List(dir, entries);
+        for (auto& entry : entries)
+        {
+            std::string path = Tree::Join(dir, entry.first);
+            if (entry.second) Scan(path);
+            else if (rules.Matches(path)) Add(path);
+        }
+    }
+
+    // Drops the watches and matches at and below `path`.
+    void Forget(const std::string& path)
+    {
+        std::string prefix = path.empty() ? "" : path + "/";
+
+        auto watch = watches.find(path);
+        if (watch != watches.end())
+        {
+            Unwatch(watch->second, path);
+            watches.erase(watch);
+        }
+
+        for (auto it = watches.lower_bound(prefix); it != watches.end() && boost::starts_with(it->first, prefix);)
+        {
+            Unwatch(it->second, it->first);
+            it = watches.erase(it);
+        }
+
+        Remove(path);
+        auto it = matched.lower_bound(prefix);
+        while (it != matched.end() && boost::starts_with(*it, prefix))
+        {
+            std::string child = *it++;
+            Remove(child);
+        }
+    }
+
+    // Removes watch `wd` unless it has since been handed to another path,
+    // which happens when the directory was renamed and scanned again.
+    void Unwatch(int wd, const std::string& dir)
+    {
+        auto it = dirs.find(wd);
+        if (it == dirs.end() || it->second != dir) return;
+        inotify_rm_watch(fd, wd);
+        dirs.erase(it);
+    }
+
+    // Membership changes cancel out within a batch.
+    void Add(const std::string& path)
+    {
+        if (!matched.insert(path).second) return;
+        if (!removed.erase(path)) added.insert(path);
+    }
+
+    void Remove(const std::string& path)
+    {
+        if (!matched.count(path)) return;
+        if (!added.erase(path)) removed.insert(path);
+        matched.erase(path);
+    }
+
+    Tree tree;
+    GlobSet rules;
+    int fd;
+    std::unordered_map<int, std::string> dirs;
+    std::map<std::string, int> watches;
+    std::set<std::string> matched;
+    std::set<std::string> added, removed;
+};
+#endif
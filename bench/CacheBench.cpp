@@ -0,0 +1,36 @@
+#pragma once
+#include "Fixtures.cpp"
+#include "../Cache.cpp"
+
+#ifdef __linux__
+static void Cache()
+{
+    std::cout << "cache: MatchCache walks over 1000 directories of 50 files\n";
+
+    Fixture tree(1000, 50);
+    std::vector<std::string> rules = Rules(400, true);
+    rules.push_back("src/**/*.ts");
+    rules.push_back("!src/**/f1?.ts");
+    std::string file = tree.root + ".cache";
+
+    // nothing changed within the settle window is saved
+    const unsigned settle = 100;
+    std::this_thread::sleep_for(std::chrono::milliseconds(settle + 50));
+
+    for (bool warm : { false, true })
+    {
+        MatchCache cache(file, rules, settle);
+        size_t matched = 0;
+        double seconds = Seconds([&] { matched = cache.Walk(tree.root).size(); });
+        cache.Save();
+
+        std::cout << "  " << (warm ? "warm" : "cold") << ": " << std::fixed << std::setprecision(1)
+            << seconds * 1e3 << " ms, " << cache.Stats().reused << " directories reused, "
+            << cache.Stats().scanned << " scanned, " << matched << " files matched\n";
+    }
+
+    unlink(file.c_str());
+}
+#else
+static void Cache() { std::cout << "cache: needs Linux, skipped\n"; }
+#endif
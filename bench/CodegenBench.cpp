@@ -0,0 +1,36 @@
+#pragma once
+#include "Fixtures.cpp"
+#include "ConfigsBench.cpp"
+#include "../globgen/Generator.cpp"
+// the matcher globgen emits for globgen/sample.txt
+#include "../globgen/Sample.cpp"
+
+static void Codegen()
+{
+    std::cout << "codegen: globgen's sample matcher against GlobSet over 10000 repository paths\n";
+
+    std::string source = __FILE__;
+    std::ifstream input(source.substr(0, source.find_last_of("/\\") + 1) + "../globgen/sample.txt");
+    if (!input)
+    {
+        std::cout << "  globgen/sample.txt not found, skipped\n";
+        return;
+    }
+
+    std::vector<std::string> rules = Generator::Read(input);
+    std::vector<std::string> files = RepositoryPaths(10000);
+    std::vector<PathView> views(files.begin(), files.end());
+    GlobSet set(rules);
+
+    size_t generated = 0, compiled = 0, viewed = 0;
+    double emitted = Seconds([&] { for (auto& file : files) generated += IsSample(file); });
+    double strings = Seconds([&] { for (auto& file : files) compiled += set.Matches(file); });
+    double split = Seconds([&] { for (auto& view : views) viewed += set.Matches(view); });
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "  generated:          " << emitted / files.size() * 1e9 << " ns/path\n"
+        << "  GlobSet:            " << strings / files.size() * 1e9 << " ns/path\n"
+        << "  GlobSet, PathView:  " << split / files.size() * 1e9 << " ns/path, " << generated << " matched\n";
+    if (generated != compiled || compiled != viewed)
+        std::cout << "  results differ: " << generated << ", " << compiled << " and " << viewed << " matches\n";
+}
@@ -0,0 +1,27 @@
+#pragma once
+#include "Fixtures.cpp"
+
+static void Compile()
+{
+    std::cout << "compile: GlobSet compile time by thread count\n";
+
+    // beyond the core count this shows what the threads cost
+    unsigned cores = std::max(1u, std::thread::hardware_concurrency());
+    std::vector<unsigned> counts;
+    for (unsigned threads = 1; threads < std::max(cores, 4u); threads *= 2) counts.push_back(threads);
+    counts.push_back(std::max(cores, 4u));
+
+    for (bool excludes : { false, true })
+    {
+        std::vector<std::string> rules = Rules(50000, excludes);
+        double serial = 0;
+        for (unsigned threads : counts)
+        {
+            double seconds = Seconds([&] { GlobSet set(rules, threads); });
+            if (threads == 1) serial = seconds;
+            std::cout << "  50000 rules, " << (excludes ? "with excludes" : "includes only") << ", "
+                << std::setw(2) << threads << " threads: " << std::fixed << std::setprecision(3) << seconds
+                << " s (" << std::setprecision(2) << serial / seconds << "x)\n";
+        }
+    }
+}
@@ -0,0 +1,112 @@
+#pragma once
+#include "Fixtures.cpp"
+
+// Rule lists of the kind projects keep in their ignore files and tool
+// configurations, written out by hand.
+static std::vector<std::pair<std::string, std::vector<std::string>>> ConfigSets()
+{
+    std::vector<std::pair<std::string, std::vector<std::string>>> configs{
+        { "gitignore", {
+            "**/node_modules/**", "**/bower_components/**", "**/jspm_packages/**",
+            "**/dist/**", "**/build/**", "**/out/**", "**/coverage/**", "**/.nyc_output/**",
+            "**/*.log", "**/npm-debug.log*", "**/yarn-debug.log*", "**/yarn-error.log*",
+            "**/.env", "**/.env.*", "!**/.env.example", "**/*.tsbuildinfo",
+            "**/.cache/**", "**/.parcel-cache/**", "**/.next/**", "**/.nuxt/**",
+            "**/.DS_Store", "**/Thumbs.db", "**/*.sw?", "**/*~",
+            "**/.idea/**", "**/.vscode/*", "!**/.vscode/settings.json", "!**/.vscode/extensions.json",
+            "**/__pycache__/**", "**/*.py[cod]", "**/.pytest_cache/**", "**/*.egg-info/**",
+            "**/*.o", "**/*.obj", "**/*.so", "**/*.dylib", "**/*.dll", "**/*.a", "**/*.lib",
+            "**/target/**", "**/*.class", "**/*.jar", "**/tmp/**", "**/*.tmp" } },
+        { "eslint", {
+            "src/**/*.{js,jsx,ts,tsx,mjs,cjs}", "test/**/*.{js,ts}", "scripts/*.{js,mjs}",
+            "*.config.{js,cjs,mjs,ts}", "!**/*.d.ts", "!**/__generated__/**", "!**/*.min.js",
+            "!src/**/vendor/**", "src/**/vendor/shim.js" } },
+        { "tsconfig", {
+            "src/**/*", "types/**/*.d.ts", "test/**/*.ts", "!**/*.spec.ts", "!**/*.test.ts",
+            "!**/node_modules/**", "!**/dist/**", "!src/**/*.stories.tsx" } },
+    };
+
+    // an owners file listing each package of a large monorepo on its own
+    std::vector<std::string> owners;
+    for (size_t i = 0; i < 500; i++)
+    {
+        std::string n = std::to_string(i);
+        owners.push_back("packages/pkg" + n + "/**");
+        if (i % 10 == 0) owners.push_back("!packages/pkg" + n + "/{CHANGELOG,README}.md");
+    }
+    configs.emplace_back("owners", owners);
+
+    return configs;
+}
+
+// Paths of a JavaScript monorepo with its build output and editor files.
+static std::vector<std::string> RepositoryPaths(size_t count)
+{
+    static const char* dirs[] = { "src/components/button", "src/lib/vendor", "src/__generated__", "test/unit",
+        "types", "scripts", "node_modules/lodash/fp", "dist/assets", ".vscode", "coverage/lcov-report",
+        "packages/pkg7/src", "packages/pkg230/lib", "packages/pkg480", "tools/.cache" };
+    static const char* names[] = { "index.ts", "button.tsx", "button.stories.tsx", "util.spec.ts", "api.d.ts",
+        "main.min.js", "shim.js", "build.mjs", "settings.json", "debug.log", "README.md", "CHANGELOG.md",
+        "vite.config.ts", ".env.local", "mod.pyc", "a.tmp" };
+
+    std::mt19937 random(2);
+    std::vector<std::string> paths;
+    for (size_t i = 0; i < count; i++)
+    {
+        const char* name = names[random() % (sizeof names / sizeof *names)];
+        // about one path in five sits at the root
+        if (random() % 5 == 0) paths.push_back(name);
+        else paths.push_back(std::string(dirs[random() % (sizeof dirs / sizeof *dirs)]) + "/" + name);
+    }
+
+    return paths;
+}
+
+static void Configs()
+{
+    std::cout << "configs: hand-written rule lists against 10000 repository paths\n";
+
+    std::vector<std::string> files = RepositoryPaths(10000);
+    std::vector<PathView> views(files.begin(), files.end());
+
+    for (auto& config : ConfigSets())
+    {
+        auto& rules = config.second;
+        std::unique_ptr<GlobSet> set;
+        double compile = Seconds([&] { set.reset(new GlobSet(rules)); });
+
+        size_t alternatives = 0;
+        for (auto& group : set->Groups()) alternatives += group.set.size();
+
+        size_t matched = 0;
+        double pooled = Seconds([&] { for (auto& view : views) matched += set->Matches(view); });
+
+        // what a caller without GlobSet does: every rule on its own, the
+        // last one that applies deciding
+        std::vector<Glob> globs;
+        std::vector<bool> negated;
+        for (auto& rule : rules)
+        {
+            negated.push_back(rule[0] == '!');
+            globs.emplace_back(negated.back() ? rule.substr(1) : rule);
+        }
+
+        size_t naive = 0;
+        double separate = Seconds([&]
+        {
+            for (auto& file : files)
+                for (size_t r = globs.size(); r-- > 0;)
+                    if (globs[r].Matches(file))
+                    {
+                        naive += !negated[r];
+                        break;
+                    }
+        });
+
+        std::cout << "  " << std::left << std::setw(10) << config.first << std::right << std::setw(4) << rules.size()
+            << " rules, " << std::setw(4) << alternatives << " alternatives: compile " << std::fixed << std::setprecision(2)
+            << compile * 1e3 << " ms, " << pooled / files.size() * 1e9 << " ns/path pooled, "
+            << separate / files.size() * 1e9 << " ns/path rule by rule, " << matched << " matched\n";
+        if (matched != naive) std::cout << "  results differ: " << matched << " and " << naive << " matches\n";
+    }
+}
@@ -0,0 +1,95 @@
+#pragma once
+#include "../Match.cpp"
+#include <chrono>
+#include <fstream>
+#include <iomanip>
+#include <iostream>
+#include <random>
+
+#ifdef __linux__
+#include <sys/stat.h>
+#include <ftw.h>
+#include <unistd.h>
+#endif
+
+typedef std::chrono::steady_clock Clock;
+
+template <class Work>
+static double Seconds(Work work)
+{
+    auto start = Clock::now();
+    work();
+    return std::chrono::duration<double>(Clock::now() - start).count();
+}
+
+// `count` rules shaped like a large repository's configuration. With
+// `excludes` every fourth rule excludes generated files again, which splits
+// the list into many small groups.
+static std::vector<std::string> Rules(size_t count, bool excludes)
+{
+    std::vector<std::string> rules;
+    for (size_t i = 0; i < count; i++)
+    {
+        std::string n = std::to_string(i);
+        switch (i % 4)
+        {
+            case 0: rules.push_back("src/m" + n + "/**/*.{js,ts}"); break;
+            case 1: rules.push_back("vendor/**/lib" + n + "/[a-m]*.c"); break;
+            case 2: rules.push_back("packages/*/pkg" + n + "/**/*.spec.{js,ts}"); break;
+            case 3: rules.push_back(excludes ? "!src/m" + std::to_string(i - 3) + "/gen/**" : "docs/v" + n + "/**/*.md"); break;
+        }
+    }
+
+    return rules;
+}
+
+// Paths for Rules(rules, ...), about half of them matched.
+static std::vector<PathView> Paths(size_t rules, size_t count)
+{
+    std::mt19937 random(1);
+    std::vector<PathView> paths;
+    for (size_t i = 0; i < count; i++)
+    {
+        std::string n = std::to_string(random() % (rules + rules / 4));
+        switch (random() % 4)
+        {
+            case 0: paths.emplace_back("src/m" + n + "/lib/util.ts"); break;
+            case 1: paths.emplace_back("vendor/zlib/src/lib" + n + "/inflate.c"); break;
+            case 2: paths.emplace_back("packages/core/pkg" + n + "/test/a.spec.js"); break;
+            case 3: paths.emplace_back("build/out" + n + "/bundle.js.map"); break;
+        }
+    }
+
+    return paths;
+}
+
+#ifdef __linux__
+// A tree of `dirs` directories holding `files` files each, under a new
+// temporary directory.
+struct Fixture
+{
+    Fixture(size_t dirs, size_t files)
+    {
+        char name[] = "/tmp/glob-bench.XXXXXX";
+        if (!mkdtemp(name)) throw std::runtime_error("mkdtemp failed");
+        root = name;
+
+        mkdir((root + "/src").c_str(), 0755);
+        for (size_t d = 0; d < dirs; d++)
+        {
+            std::string dir = "src/m" + std::to_string(d);
+            mkdir((root + "/" + dir).c_str(), 0755);
+            for (size_t f = 0; f < files; f++)
+                std::ofstream(root + "/" + dir + "/f" + std::to_string(f) + (f % 2 ? ".ts" : ".txt"));
+        }
+    }
+
+    ~Fixture()
+    {
+        nftw(root.c_str(), [](const char* path, const struct stat*, int, FTW*) { return remove(path); },
+            16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    std::string root;
+};
+#endif
@@ -0,0 +1,53 @@
+#pragma once
+#include "Fixtures.cpp"
+
+static void Index()
+{
+    std::cout << "index: literal alternatives through the hash tables and one by one\n";
+
+    // hundreds of extensions, and thousands of exact paths such as a
+    // generated file list
+    std::string extensions, names;
+    for (size_t i = 0; i < 400; i++) extensions += (i ? "," : "") + ("x" + std::to_string(i));
+    for (size_t i = 0; i < 4000; i++) names += (i ? "," : "") + ("src/m" + std::to_string(i % 40) + "/f" + std::to_string(i) + ".c");
+
+    std::mt19937 random(3);
+    std::vector<PathView> paths;
+    for (size_t i = 0; i < 1000; i++)
+    {
+        // about half of them hits
+        size_t n = random() % 800, m = random() % 8000;
+        if (i % 2) paths.emplace_back("src/lib/a.x" + std::to_string(n));
+        else paths.emplace_back("src/m" + std::to_string(m % 40) + "/f" + std::to_string(m) + ".c");
+    }
+
+    for (auto& pattern : { "**/*.{" + extensions + "}", "{" + names + "}" })
+    {
+        GlobSet set({ pattern });
+        auto& group = set.Groups()[0];
+
+        size_t indexed = 0;
+        double lookup = Seconds([&] { for (auto& path : paths) indexed += set.Matches(path); });
+
+        // the same alternatives, prefilters included, the way they are
+        // matched without the index
+        size_t sequential = 0;
+        Glob::PrefilterStats stats;
+        double loop = Seconds([&]
+        {
+            for (auto& path : paths)
+                for (size_t i = 0; i < group.set.size(); i++)
+                    if (Glob::Admits(group.filters[i], path, stats) && Glob::MatchOne(path.parts, group.set[i], false))
+                    {
+                        sequential++;
+                        break;
+                    }
+        });
+
+        std::cout << std::fixed << std::setprecision(2)
+            << "  " << std::setw(4) << group.set.size() << (pattern[0] == '*' ? " extensions" : " exact paths")
+            << " (" << group.index.Size() << " indexed): " << lookup / paths.size() * 1e6 << " us/path, one by one "
+            << loop / paths.size() * 1e6 << " us/path\n";
+        if (indexed != sequential) std::cout << "  results differ: " << indexed << " and " << sequential << " matches\n";
+    }
+}
@@ -0,0 +1,34 @@
+#pragma once
+#include "Fixtures.cpp"
+
+static void Trie()
+{
+    std::cout << "trie: 10000 rules through the segment trie and one by one\n";
+
+    GlobSet set(Rules(10000, false));
+    std::vector<PathView> paths = Paths(10000, 1000);
+    auto& group = set.Groups()[0];
+
+    size_t merged = 0;
+    double trie = Seconds([&] { for (auto& path : paths) merged += set.Matches(path); });
+
+    // the same alternatives, prefilters included, the way they are matched
+    // when no trie is built
+    size_t sequential = 0;
+    Glob::PrefilterStats stats;
+    double loop = Seconds([&]
+    {
+        for (auto& path : paths)
+            for (size_t i = 0; i < group.set.size(); i++)
+                if (Glob::Admits(group.filters[i], path, stats) && Glob::MatchOne(path.parts, group.set[i], false))
+                {
+                    sequential++;
+                    break;
+                }
+    });
+
+    std::cout << std::fixed << std::setprecision(2)
+        << "  trie (" << group.trie.Size() << " alternatives): " << trie / paths.size() * 1e6 << " us/path\n"
+        << "  one by one:                " << loop / paths.size() * 1e6 << " us/path\n";
+    if (merged != sequential) std::cout << "  results differ: " << merged << " and " << sequential << " matches\n";
+}
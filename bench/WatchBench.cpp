@@ -0,0 +1,32 @@
+#pragma once
+#include "Fixtures.cpp"
+#include "../Watch.cpp"
+
+#ifdef __linux__
+static void Watch()
+{
+    std::cout << "watch: GlobWatch setup and update cost by tree size\n";
+
+    std::vector<std::string> rules{ "src/**/*.ts", "!src/**/f1?.ts" };
+    for (size_t dirs : { 10, 100, 1000 })
+    {
+        Fixture tree(dirs, 100);
+        std::unique_ptr<GlobWatch> watch;
+        double setup = Seconds([&] { watch.reset(new GlobWatch(tree.root, rules)); });
+
+        // one new file in each of up to 100 directories, applied as one batch
+        size_t created = std::min<size_t>(dirs, 100);
+        for (size_t d = 0; d < created; d++)
+            std::ofstream(tree.root + "/src/m" + std::to_string(d * dirs / created) + "/new.ts");
+
+        GlobWatch::Changes changes;
+        double poll = Seconds([&] { changes = watch->Poll(1000); });
+
+        std::cout << "  " << std::setw(6) << dirs * 100 << " files: setup " << std::fixed << std::setprecision(1)
+            << setup * 1e3 << " ms, " << changes.added.size() << " added in " << poll * 1e3 << " ms ("
+            << std::setprecision(2) << poll / std::max<size_t>(1, changes.added.size()) * 1e6 << " us each)\n";
+    }
+}
+#else
+static void Watch() { std::cout << "watch: needs Linux, skipped\n"; }
+#endif
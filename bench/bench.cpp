@@ -0,0 +1,106 @@
+// Measures the costs the optimizations in Match.cpp, Watch.cpp and Cache.cpp
+// are meant to cut, on synthetic rule lists and trees.
+//
+//   bench [configs] [index] [reload] [compile] [trie] [codegen] [cache] [watch]
+//
+// With no arguments every section runs. `cache` and `watch` need Linux and
+// build their trees in the temporary directory.
+//
+//   configs  ignore-file and tool rule lists pooled by GlobSet and rule by rule
+//   index    hundreds of extensions and thousands of paths through LiteralIndex
+//   reload   reader throughput with and without a writer publishing new rules
+//   compile  GlobSet compile time by thread count
+//   trie     matching 10k rules through the segment trie and one by one
+//   codegen  the matcher globgen emitted for globgen/sample.txt against GlobSet
+//   cache    MatchCache walks with no cache file and with a saved one
+//   watch    GlobWatch setup and update cost by tree size
+//
+// Each section lives in its own file next to this one, with the feature it
+// measures; this file holds `reload` and the driver.
+#include "Fixtures.cpp"
+#include "ConfigsBench.cpp"
+#include "IndexBench.cpp"
+#include "CompileBench.cpp"
+#include "TrieBench.cpp"
+#include "CodegenBench.cpp"
+#include "CacheBench.cpp"
+#include "WatchBench.cpp"
+#include <set>
+
+static void Reload()
+{
+    std::cout << "reload: reader throughput while rules are replaced\n";
+
+    std::vector<std::string> rules = Rules(200, true);
+    std::vector<PathView> paths = Paths(200, 1000);
+    Published<GlobSet> published(std::unique_ptr<GlobSet>(new GlobSet(rules)));
+    // the writer gets a core of its own where there is one to spare
+    unsigned readers = std::max(2u, std::thread::hardware_concurrency()) - 1;
+
+    for (bool reloading : { false, true })
+    {
+        std::atomic<bool> done{ false };
+        std::atomic<size_t> matched{ 0 }, hits{ 0 };
+        size_t reloads = 0;
+
+        std::vector<std::thread> threads;
+        for (unsigned r = 0; r < readers; r++)
+            threads.emplace_back([&]
+            {
+                size_t count = 0, hit = 0;
+                while (!done)
+                {
+                    for (auto& path : paths) hit += published.Matches(path);
+                    count += paths.size();
+                }
+                matched += count;
+                hits += hit;
+            });
+
+        // the writer compiles and publishes as fast as it can
+        auto start = Clock::now();
+        while (Clock::now() - start < std::chrono::seconds(1))
+        {
+            if (!reloading)
+            {
+                std::this_thread::sleep_for(std::chrono::milliseconds(10));
+                continue;
+            }
+
+            published.Publish(std::unique_ptr<GlobSet>(new GlobSet(rules)));
+            reloads++;
+        }
+
+        done = true;
+        double seconds = std::chrono::duration<double>(Clock::now() - start).count();
+        for (auto& thread : threads) thread.join();
+
+        std::cout << "  " << readers << " readers, " << std::setw(5) << reloads << " reloads: "
+            << std::fixed << std::setprecision(2) << matched / seconds / 1e6 << " M matches/s\n";
+    }
+
+    published.Reclaim();
+}
+
+int main(int argc, char** argv)
+{
+    std::vector<std::pair<std::string, void (*)()>> sections{
+        { "configs", Configs }, { "index", Index }, { "reload", Reload }, { "compile", Compile },
+        { "trie", Trie }, { "codegen", Codegen }, { "cache", Cache }, { "watch", Watch } };
+
+    std::set<std::string> chosen(argv + 1, argv + argc);
+    for (auto& section : sections) chosen.erase(section.first);
+    if (!chosen.empty())
+    {
+        std::cerr << "usage: bench [configs] [index] [reload] [compile] [trie] [codegen] [cache] [watch]\n";
+        return 2;
+    }
+
+    chosen.insert(argv + 1, argv + argc);
+
+    for (auto& section : sections)
+        if (chosen.empty() || chosen.count(section.first))
+            section.second();
+
+    return 0;
+}
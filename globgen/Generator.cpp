@@ -0,0 +1,527 @@
+#pragma once
+#include "../Match.cpp"
+#include <bitset>
+#include <istream>
+#include <map>
+#include <set>
+
+// Emits the C++ source of a matcher for a rule list. globgen is a thin
+// command line around it.
+struct Generator
+{
+    Generator(const std::string& function, const std::vector<std::string>& patterns)
+        : function(function), rules(patterns)
+    {
+    }
+
+    // Rules from a rule file: one per line, surrounding whitespace trimmed,
+    // blank lines and lines starting with `#` skipped.
+    static std::vector<std::string> Read(std::istream& input)
+    {
+        std::vector<std::string> patterns;
+        for (std::string line; std::getline(input, line);)
+        {
+            boost::trim(line);
+            if (!line.empty() && line[0] != '#') patterns.push_back(line);
+        }
+
+        return patterns;
+    }
+
+    std::string Emit()
+    {
+        std::ostringstream entry;
+        entry << "bool " << function << "(const char* path, size_t length)\n"
+            << "{\n"
+            << "    size_t count = 1;\n"
+            << "    for (size_t i = 0; i < length; i++) count += path[i] == '/';\n\n"
+            << "    Segment small[32];\n"
+            << "    std::unique_ptr<Segment[]> large;\n"
+            << "    Segment* file = small;\n"
+            << "    if (count > 32)\n"
+            << "    {\n"
+            << "        large.reset(new Segment[count]);\n"
+            << "        file = large.get();\n"
+            << "    }\n\n"
+            << "    size_t start = 0, fi = 0;\n"
+            << "    for (size_t i = 0; i <= length; i++)\n"
+            << "        if (i == length || path[i] == '/')\n"
+            << "        {\n"
+            << "            file[fi++] = Segment{ path + start, i - start };\n"
+            << "            start = i + 1;\n"
+            << "        }\n\n"
+            << "    // rule groups, last first\n";
+
+        auto& groups = rules.Groups();
+        for (size_t g = groups.size(); g-- > 0;)
+        {
+            auto& group = groups[g];
+            if (group.set.empty()) continue;
+
+            // alternatives that only differ in their last segment, such as
+            // the expansions of `**/*.{js,ts}`, share one DFA for it
+            std::vector<std::string> calls;
+            std::vector<bool> merged(group.set.size());
+            for (size_t i = 0; i < group.set.size(); i++)
+            {
+                if (merged[i]) continue;
+
+                auto& parts = group.parts[i];
+                std::vector<std::string> lasts;
+                std::vector<size_t> members;
+                if (Mergeable(group.set[i].back(), parts.back()))
+                    for (size_t j = i; j < group.set.size(); j++)
+                    {
+                        auto& other = group.parts[j];
+                        if (!merged[j] && other.size() == parts.size()
+                            && std::equal(parts.begin(), parts.end() - 1, other.begin())
+                            && Mergeable(group.set[j].back(), other.back()))
+                        {
+                            lasts.push_back(other.back());
+                            members.push_back(j);
+                        }
+                    }
+
+                std::string last = lasts.size() > 1 ? SegmentMatcher(lasts) : "";
+                if (!last.empty())
+                    for (size_t j : members) merged[j] = true;
+                calls.push_back(Alternative(group.set[i], parts, last));
+            }
+
+            entry << "    if (";
+            for (size_t i = 0; i < calls.size(); i++)
+            {
+                if (i) entry << "\n        || ";
+                entry << calls[i] << "(file, 0, count)";
+            }
+            entry << ")\n        return " << (group.negate ? "false" : "true") << ";\n";
+        }
+
+        entry << "    return false;\n"
+            << "}\n\n"
+            << "bool " << function << "(const std::string& path)\n"
+            << "{\n"
+            << "    return " << function << "(path.data(), path.length());\n"
+            << "}\n";
+
+        std::ostringstream out;
+        out << "// Generated by globgen. Do not edit.\n"
+            << "#include <cstddef>\n"
+            << "#include <cstring>\n"
+            << "#include <memory>\n";
+        if (fallbacks) out << "#include <regex>\n";
+        out << "#include <string>\n\n"
+            << "namespace\n"
+            << "{\n"
+            << "    struct Segment\n"
+            << "    {\n"
+            << "        const char* data;\n"
+            << "        size_t length;\n"
+            << "    };\n\n"
+            << "    inline bool Is(const Segment& segment, const char* literal, size_t length)\n"
+            << "    {\n"
+            << "        return segment.length == length && std::memcmp(segment.data, literal, length) == 0;\n"
+            << "    }\n\n"
+            << "    inline bool Hidden(const Segment& segment)\n"
+            << "    {\n"
+            << "        return segment.length && segment.data[0] == '.';\n"
+            << "    }\n";
+        for (auto& code : segments) out << "\n" << code;
+        for (auto& code : alternatives) out << "\n" << code;
+        out << "}\n\n" << entry.str();
+        return out.str();
+    }
+
+    size_t Fallbacks() const { return fallbacks; }
+
+private:
+    struct Token
+    {
+        enum Kind { Char, Any, Star, Class } kind;
+        std::bitset<256> set;
+    };
+
+    // Splits a segment pattern into tokens the DFA builder understands.
+    // Returns false for anything whose regex semantics it does not model.
+    static bool Tokenize(const std::string& part, std::vector<Token>& tokens)
+    {
+        auto literal = [&](unsigned char c)
+        {
+            Token token{ Token::Char };
+            token.set.set(c);
+            tokens.push_back(token);
+        };
+
+        for (size_t i = 0; i < part.length(); i++)
+        {
+            unsigned char c = part[i];
+            bool list = i + 1 < part.length() && part[i + 1] == '(';
+
+            switch (c)
+            {
+                case '\\':
+                    literal(i + 1 < part.length() ? part[++i] : c);
+                    continue;
+
+                case '*':
+                    if (list) return false;
+                    if (tokens.empty() || tokens.back().kind != Token::Star)
+                        tokens.push_back(Token{ Token::Star });
+                    continue;
+
+                case '?':
+                    if (list) return false;
+                    tokens.push_back(Token{ Token::Any });
+                    continue;
+
+                case '+':
+                case '@':
+                case '!':
+                    if (list) return false;
+                    literal(c);
+                    continue;
+
+                case '[':
+                {
+                    Token token{ Token::Class };
+                    size_t j = i + 1;
+                    bool negate = j < part.length() && (part[j] == '!' || part[j] == '^');
+                    if (negate) j++;
+                    // `]` straight after `[` is a member, not the end
+                    else if (j < part.length() && part[j] == ']')
+                    {
+                        if (j + 2 < part.length() && part[j + 1] == '-' && part[j + 2] != ']') return false;
+                        token.set.set(']');
+                        j++;
+                    }
+
+                    for (; j < part.length() && part[j] != ']'; j++)
+                    {
+                        unsigned char first = part[j];
+                        if (first == '\\' || first == '[' || first < 0x20 || first > 0x7e) return false;
+
+                        unsigned char last = first;
+                        if (j + 2 < part.length() && part[j + 1] == '-' && part[j + 2] != ']')
+                        {
+                            last = part[j + 2];
+                            if (last == '\\' || last == '[' || last < first || last > 0x7e) return false;
+                            j += 2;
+                        }
+
+                        for (unsigned c = first; c <= last; c++) token.set.set(c);
+                    }
+
+                    if (j >= part.length() || token.set.none()) return false;
+                    if (negate) token.set.flip();
+                    tokens.push_back(token);
+                    i = j;
+                    continue;
+                }
+
+                default:
+                    literal(c);
+                    continue;
+            }
+        }
+
+        return true;
+    }
+
+    static bool Accepts(const Token& token, unsigned char c)
+    {
+        return token.kind == Token::Any || token.kind == Token::Star || token.set.test(c);
+    }
+
+    // An NFA position: token `second` of alternative `first`.
+    typedef std::pair<size_t, size_t> Position;
+    typedef std::set<Position> State;
+
+    // Marks the start state, where wildcards may not consume a leading dot.
+    static const size_t start = (size_t)-1;
+
+    // Positions reachable from `state` without consuming input.
+    static State Closure(const std::vector<std::vector<Token>>& alternatives, State state)
+    {
+        for (auto position : State(state))
+        {
+            if (position.first == start) continue;
+            auto& tokens = alternatives[position.first];
+            for (size_t p = position.second; p < tokens.size() && tokens[p].kind == Token::Star; p++)
+                state.insert(Position(position.first, p + 1));
+        }
+        return state;
+    }
+
+    static std::string CharLiteral(unsigned c)
+    {
+        if (c == '\'' || c == '\\') return std::string("'\\") + (char)c + "'";
+        if (c >= 0x20 && c <= 0x7e) return std::string("'") + (char)c + "'";
+        return std::to_string(c);
+    }
+
+    static std::string StringLiteral(const std::string& s)
+    {
+        std::ostringstream out;
+        out << '"';
+        for (unsigned char c : s)
+        {
+            if (c == '"' || c == '\\') out << '\\' << c;
+            else if (c >= 0x20 && c <= 0x7e && c != '?') out << c;
+            else out << '\\' << std::oct << std::setw(3) << std::setfill('0') << (unsigned)c << std::dec;
+        }
+        out << '"';
+        return out.str();
+    }
+
+    // Quoted so a trailing backslash cannot splice the next line into the
+    // comment.
+    static std::string Comment(const std::string& part)
+    {
+        std::string comment = "`";
+        for (unsigned char c : part) comment += c >= 0x20 && c <= 0x7e ? (char)c : '?';
+        return comment + "`";
+    }
+
+    // Subset construction over the tokens of one or more segment patterns,
+    // accepting a name any of them matches, emitted as nested switches.
+    // Returns false when the automaton grows unreasonably large.
+    static bool Dfa(const std::vector<std::vector<Token>>& alternatives, std::ostringstream& out)
+    {
+        const size_t limit = 256;
+        std::map<State, size_t> ids;
+        std::vector<State> states;
+        std::vector<std::vector<long>> next;
+
+        auto id = [&](const State& state) -> long
+        {
+            if (state.empty()) return -1;
+            auto it = ids.find(state);
+            if (it != ids.end()) return (long)it->second;
+            ids[state] = states.size();
+            states.push_back(state);
+            return (long)states.size() - 1;
+        };
+
+        State initial{ Position(start, 0) };
+        for (size_t a = 0; a < alternatives.size(); a++) initial.insert(Position(a, 0));
+        id(Closure(alternatives, initial));
+
+        for (size_t s = 0; s < states.size(); s++)
+        {
+            if (states.size() > limit) return false;
+
+            bool first = states[s].count(Position(start, 0)) != 0;
+            std::vector<long> row(256);
+            for (unsigned c = 0; c < 256; c++)
+            {
+                State target;
+                for (auto position : states[s])
+                {
+                    if (position.first == start) continue;
+                    auto& tokens = alternatives[position.first];
+                    size_t p = position.second;
+                    if (p == tokens.size() || !Accepts(tokens[p], c)) continue;
+                    // wildcards in front never match a leading dot
+                    if (first && c == '.' && tokens[0].kind != Token::Char) continue;
+                    target.insert(Position(position.first, tokens[p].kind == Token::Star ? p : p + 1));
+                }
+                row[c] = id(Closure(alternatives, target));
+            }
+            next.push_back(row);
+        }
+
+        out << "        size_t state = 0;\n"
+            << "        for (size_t i = 0; i < length; i++)\n"
+            << "        {\n"
+            << "            unsigned char c = data[i];\n"
+            << "            switch (state)\n"
+            << "            {\n";
+
+        for (size_t s = 0; s < states.size(); s++)
+        {
+            // the most common target becomes the default label
+            std::map<long, std::vector<unsigned>> targets;
+            for (unsigned c = 0; c < 256; c++) targets[next[s][c]].push_back(c);
+
+            long fallback = -1;
+            size_t most = 0;
+            for (auto& target : targets)
+                if (target.second.size() > most)
+                {
+                    most = target.second.size();
+                    fallback = target.first;
+                }
+
+            auto transition = [](long target) -> std::string
+            {
+                return target < 0 ? "return false;" : "state = " + std::to_string(target) + "; break;";
+            };
+
+            out << "                case " << s << ":\n"
+                << "                    switch (c)\n"
+                << "                    {\n";
+            for (auto& target : targets)
+            {
+                if (target.first == fallback) continue;
+                out << "                        ";
+                for (unsigned c : target.second) out << "case " << CharLiteral(c) << ": ";
+                out << transition(target.first) << "\n";
+            }
+            out << "                        default: " << transition(fallback) << "\n"
+                << "                    }\n"
+                << "                    break;\n";
+        }
+
+        out << "            }\n"
+            << "        }\n\n";
+
+        std::vector<size_t> accepting;
+        for (size_t s = 0; s < states.size(); s++)
+            for (auto position : states[s])
+                if (position.first != start && position.second == alternatives[position.first].size())
+                {
+                    accepting.push_back(s);
+                    break;
+                }
+
+        out << "        return ";
+        if (accepting.empty()) out << "false";
+        for (size_t i = 0; i < accepting.size(); i++)
+            out << (i ? " || " : "") << "state == " << accepting[i];
+        out << ";\n";
+        return true;
+    }
+
+    // Emits a DFA matching a name any of `parts` matches and returns its
+    // name, or an empty string when they cannot be compiled to one.
+    std::string SegmentMatcher(const std::vector<std::string>& parts)
+    {
+        std::string key = boost::join(parts, "\n");
+        auto known = segmentNames.find(key);
+        if (known != segmentNames.end()) return known->second;
+
+        std::vector<std::vector<Token>> alternatives(parts.size());
+        for (size_t i = 0; i < parts.size(); i++)
+            if (!Tokenize(parts[i], alternatives[i])) return "";
+
+        std::ostringstream dfa;
+        if (!Dfa(alternatives, dfa)) return "";
+
+        std::string name = "segment" + std::to_string(segments.size());
+        std::ostringstream out;
+        for (auto& part : parts) out << "    // " << Comment(part) << "\n";
+        out << "    bool " << name << "(const char* data, size_t length)\n"
+            << "    {\n"
+            // magic segments never match an empty name
+            << "        if (length == 0) return false;\n"
+            << dfa.str()
+            << "    }\n";
+        segments.push_back(out.str());
+        segmentNames[key] = name;
+        return name;
+    }
+
+    // Emits a matcher for one magic segment, falling back to its regex when
+    // the DFA builder cannot handle it.
+    std::string SegmentMatcher(const Glob::ParseItem* item, const std::string& part)
+    {
+        std::string name = SegmentMatcher(std::vector<std::string>{ part });
+        if (!name.empty()) return name;
+
+        auto known = segmentNames.find(part);
+        if (known != segmentNames.end()) return known->second;
+
+        name = "segment" + std::to_string(segments.size());
+        std::ostringstream out;
+        out << "    // " << Comment(part) << "\n"
+            << "    bool " << name << "(const char* data, size_t length)\n"
+            << "    {\n"
+            << "        static const std::regex re(" << StringLiteral("^" + item->source() + "$") << ");\n"
+            << "        return std::regex_match(data, data + length, re);\n"
+            << "    }\n";
+        fallbacks++;
+        segments.push_back(out.str());
+        segmentNames[part] = name;
+        return name;
+    }
+
+    // Whether a final segment can join a shared DFA. Empty names and `**`
+    // do not behave like one segment pattern.
+    static bool Mergeable(const Glob::ParseItem* item, const std::string& part)
+    {
+        std::vector<Token> tokens;
+        return !item->source().empty() && item->source() != "**" && Tokenize(part, tokens);
+    }
+
+    // Emits the straight-line equivalent of Glob::MatchOne for one
+    // alternative and returns the name of its entry point. A non-empty `last`
+    // names the matcher to use for the final segment.
+    std::string Alternative(const std::vector<Glob::ParseItem*>& items, const std::vector<std::string>& parts,
+        const std::string& last)
+    {
+        std::string name = "alternative" + std::to_string(alternatives.size());
+        alternatives.push_back(Suffix(name, items, parts, last, 0));
+        return name + "_0";
+    }
+
+    // Emits `<name>_<pi>` matching file[fi..] against items[pi..], plus the
+    // functions a `**` inside it continues with.
+    std::string Suffix(const std::string& name, const std::vector<Glob::ParseItem*>& items,
+        const std::vector<std::string>& parts, const std::string& last, size_t pi)
+    {
+        std::ostringstream out, rest;
+        out << "    bool " << name << "_" << pi << "(const Segment* file, size_t fi, size_t fl)\n"
+            << "    {\n";
+
+        for (; pi < items.size(); pi++)
+        {
+            auto item = items[pi];
+            bool shared = pi + 1 == items.size() && !last.empty();
+            out << "        // " << (shared ? "shared, see " + last : Comment(parts[pi])) << "\n"
+                << "        if (fi == fl) return false;\n";
+
+            if (item->source() == "**")
+            {
+                if (pi + 1 == items.size())
+                {
+                    out << "        for (; fi < fl; fi++)\n"
+                        << "            if (Hidden(file[fi])) return false;\n"
+                        << "        return true;\n"
+                        << "    }\n";
+                    return rest.str() + out.str();
+                }
+
+                rest << Suffix(name, items, parts, last, pi + 1) << "\n";
+                out << "        for (; fi < fl; fi++)\n"
+                    << "        {\n"
+                    << "            if (" << name << "_" << pi + 1 << "(file, fi, fl)) return true;\n"
+                    << "            if (Hidden(file[fi])) break;\n"
+                    << "        }\n"
+                    << "        return false;\n"
+                    << "    }\n";
+                return rest.str() + out.str();
+            }
+
+            if (shared)
+                out << "        if (!" << last << "(file[fi].data, file[fi].length)) return false;\n";
+            else if (dynamic_cast<Glob::LiteralItem*>(item))
+                out << "        if (!Is(file[fi], " << StringLiteral(item->source()) << ", "
+                    << item->source().length() << ")) return false;\n";
+            else
+                out << "        if (!" << SegmentMatcher(item, parts[pi]) << "(file[fi].data, file[fi].length)) return false;\n";
+            out << "        fi++;\n";
+        }
+
+        // one trailing empty segment is a trailing slash
+        out << "        return fi == fl || (fi == fl - 1 && file[fi].length == 0);\n"
+            << "    }\n";
+        return rest.str() + out.str();
+    }
+
+    std::string function;
+    GlobSet rules;
+    std::vector<std::string> segments;
+    std::map<std::string, std::string> segmentNames;
+    std::vector<std::string> alternatives;
+    size_t fallbacks = 0;
+};
@@ -0,0 +1,1215 @@
+// Generated by globgen. Do not edit.
+#include <cstddef>
+#include <cstring>
+#include <memory>
+#include <regex>
+#include <string>
+
+namespace
+{
+    struct Segment
+    {
+        const char* data;
+        size_t length;
+    };
+
+    inline bool Is(const Segment& segment, const char* literal, size_t length)
+    {
+        return segment.length == length && std::memcmp(segment.data, literal, length) == 0;
+    }
+
+    inline bool Hidden(const Segment& segment)
+    {
+        return segment.length && segment.data[0] == '.';
+    }
+
+    // `test_*+(foo|bar).py`
+    bool segment0(const char* data, size_t length)
+    {
+        static const std::regex re("^(\077=.)test_[^/]*\077(\077:foo|bar)+\\.py$");
+        return std::regex_match(data, data + length, re);
+    }
+
+    // `[a-m]*.md`
+    bool segment1(const char* data, size_t length)
+    {
+        if (length == 0) return false;
+        size_t state = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            unsigned char c = data[i];
+            switch (state)
+            {
+                case 0:
+                    switch (c)
+                    {
+                        case 'a': case 'b': case 'c': case 'd': case 'e': case 'f': case 'g': case 'h': case 'i': case 'j': case 'k': case 'l': case 'm': state = 1; break;
+                        default: return false;
+                    }
+                    break;
+                case 1:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 2:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'm': state = 3; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 3:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'd': state = 4; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 4:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+            }
+        }
+
+        return state == 4;
+    }
+
+    // `*.d.ts`
+    // `*.min.js`
+    bool segment2(const char* data, size_t length)
+    {
+        if (length == 0) return false;
+        size_t state = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            unsigned char c = data[i];
+            switch (state)
+            {
+                case 0:
+                    switch (c)
+                    {
+                        case '.': return false;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 1:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 2:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'd': state = 3; break;
+                        case 'm': state = 4; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 3:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 4:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'i': state = 6; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 5:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'd': state = 3; break;
+                        case 'm': state = 4; break;
+                        case 't': state = 7; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 6:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'n': state = 8; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 7:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 9; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 8:
+                    switch (c)
+                    {
+                        case '.': state = 10; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 9:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 10:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'd': state = 3; break;
+                        case 'm': state = 4; break;
+                        case 'j': state = 11; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 11:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 12; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 12:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+            }
+        }
+
+        return state == 9 || state == 12;
+    }
+
+    // `*.js`
+    // `*.jsx`
+    // `*.ts`
+    // `*.tsx`
+    // `*.mjs`
+    // `*.cjs`
+    bool segment3(const char* data, size_t length)
+    {
+        if (length == 0) return false;
+        size_t state = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            unsigned char c = data[i];
+            switch (state)
+            {
+                case 0:
+                    switch (c)
+                    {
+                        case '.': return false;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 1:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 2:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'c': state = 3; break;
+                        case 'j': state = 4; break;
+                        case 'm': state = 5; break;
+                        case 't': state = 6; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 3:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'j': state = 7; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 4:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 8; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 5:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'j': state = 9; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 6:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 10; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 7:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 11; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 8:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'x': state = 12; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 9:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 13; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 10:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'x': state = 14; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 11:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 12:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 13:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 14:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+            }
+        }
+
+        return state == 8 || state == 10 || state == 11 || state == 12 || state == 13 || state == 14;
+    }
+
+    // `*.js`
+    // `*.ts`
+    bool segment4(const char* data, size_t length)
+    {
+        if (length == 0) return false;
+        size_t state = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            unsigned char c = data[i];
+            switch (state)
+            {
+                case 0:
+                    switch (c)
+                    {
+                        case '.': return false;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 1:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 2:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'j': state = 3; break;
+                        case 't': state = 4; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 3:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 4:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 6; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 5:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 6:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+            }
+        }
+
+        return state == 5 || state == 6;
+    }
+
+    // `*.js`
+    // `*.mjs`
+    bool segment5(const char* data, size_t length)
+    {
+        if (length == 0) return false;
+        size_t state = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            unsigned char c = data[i];
+            switch (state)
+            {
+                case 0:
+                    switch (c)
+                    {
+                        case '.': return false;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 1:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 2:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'j': state = 3; break;
+                        case 'm': state = 4; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 3:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 4:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 'j': state = 6; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 5:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 6:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        case 's': state = 7; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 7:
+                    switch (c)
+                    {
+                        case '.': state = 2; break;
+                        default: state = 1; break;
+                    }
+                    break;
+            }
+        }
+
+        return state == 5 || state == 7;
+    }
+
+    // `*.config.js`
+    // `*.config.cjs`
+    // `*.config.mjs`
+    // `*.config.ts`
+    // `Makefile`
+    // `package.json`
+    // `tsconfig.json`
+    bool segment6(const char* data, size_t length)
+    {
+        if (length == 0) return false;
+        size_t state = 0;
+        for (size_t i = 0; i < length; i++)
+        {
+            unsigned char c = data[i];
+            switch (state)
+            {
+                case 0:
+                    switch (c)
+                    {
+                        case '.': return false;
+                        case 'M': state = 2; break;
+                        case 'p': state = 3; break;
+                        case 't': state = 4; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 1:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 2:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'a': state = 6; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 3:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'a': state = 7; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 4:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 's': state = 8; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 5:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'c': state = 9; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 6:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'k': state = 10; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 7:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'c': state = 11; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 8:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'c': state = 12; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 9:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'o': state = 13; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 10:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'e': state = 14; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 11:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'k': state = 15; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 12:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'o': state = 16; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 13:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'n': state = 17; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 14:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'f': state = 18; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 15:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'a': state = 19; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 16:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'n': state = 20; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 17:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'f': state = 21; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 18:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'i': state = 22; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 19:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'g': state = 23; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 20:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'f': state = 24; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 21:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'i': state = 25; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 22:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'l': state = 26; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 23:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'e': state = 27; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 24:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'i': state = 28; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 25:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'g': state = 29; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 26:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'e': state = 30; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 27:
+                    switch (c)
+                    {
+                        case '.': state = 31; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 28:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'g': state = 32; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 29:
+                    switch (c)
+                    {
+                        case '.': state = 33; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 30:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 31:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'c': state = 9; break;
+                        case 'j': state = 34; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 32:
+                    switch (c)
+                    {
+                        case '.': state = 35; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 33:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'c': state = 36; break;
+                        case 'j': state = 37; break;
+                        case 'm': state = 38; break;
+                        case 't': state = 39; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 34:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 's': state = 40; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 35:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'c': state = 9; break;
+                        case 'j': state = 41; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 36:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'o': state = 13; break;
+                        case 'j': state = 42; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 37:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 's': state = 43; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 38:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'j': state = 44; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 39:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 's': state = 45; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 40:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'o': state = 46; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 41:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 's': state = 47; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 42:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 's': state = 48; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 43:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 44:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 's': state = 49; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 45:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 46:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'n': state = 50; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 47:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'o': state = 51; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 48:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 49:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 50:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 51:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        case 'n': state = 52; break;
+                        default: state = 1; break;
+                    }
+                    break;
+                case 52:
+                    switch (c)
+                    {
+                        case '.': state = 5; break;
+                        default: state = 1; break;
+                    }
+                    break;
+            }
+        }
+
+        return state == 30 || state == 43 || state == 45 || state == 48 || state == 49 || state == 50 || state == 52;
+    }
+
+    bool alternative0_1(const Segment* file, size_t fi, size_t fl)
+    {
+        // `node_modules`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "node_modules", 12)) return false;
+        fi++;
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+            if (Hidden(file[fi])) return false;
+        return true;
+    }
+
+    bool alternative0_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+        {
+            if (alternative0_1(file, fi, fl)) return true;
+            if (Hidden(file[fi])) break;
+        }
+        return false;
+    }
+
+    bool alternative1_2(const Segment* file, size_t fi, size_t fl)
+    {
+        // `vendor`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "vendor", 6)) return false;
+        fi++;
+        // `shim.js`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "shim.js", 7)) return false;
+        fi++;
+        return fi == fl || (fi == fl - 1 && file[fi].length == 0);
+    }
+
+    bool alternative1_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `src`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "src", 3)) return false;
+        fi++;
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+        {
+            if (alternative1_2(file, fi, fl)) return true;
+            if (Hidden(file[fi])) break;
+        }
+        return false;
+    }
+
+    bool alternative2_1(const Segment* file, size_t fi, size_t fl)
+    {
+        // `test_*+(foo|bar).py`
+        if (fi == fl) return false;
+        if (!segment0(file[fi].data, file[fi].length)) return false;
+        fi++;
+        return fi == fl || (fi == fl - 1 && file[fi].length == 0);
+    }
+
+    bool alternative2_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+        {
+            if (alternative2_1(file, fi, fl)) return true;
+            if (Hidden(file[fi])) break;
+        }
+        return false;
+    }
+
+    bool alternative3_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `docs`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "docs", 4)) return false;
+        fi++;
+        // `[a-m]*.md`
+        if (fi == fl) return false;
+        if (!segment1(file[fi].data, file[fi].length)) return false;
+        fi++;
+        return fi == fl || (fi == fl - 1 && file[fi].length == 0);
+    }
+
+    bool alternative4_1(const Segment* file, size_t fi, size_t fl)
+    {
+        // shared, see segment2
+        if (fi == fl) return false;
+        if (!segment2(file[fi].data, file[fi].length)) return false;
+        fi++;
+        return fi == fl || (fi == fl - 1 && file[fi].length == 0);
+    }
+
+    bool alternative4_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+        {
+            if (alternative4_1(file, fi, fl)) return true;
+            if (Hidden(file[fi])) break;
+        }
+        return false;
+    }
+
+    bool alternative5_1(const Segment* file, size_t fi, size_t fl)
+    {
+        // `__generated__`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "__generated__", 13)) return false;
+        fi++;
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+            if (Hidden(file[fi])) return false;
+        return true;
+    }
+
+    bool alternative5_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+        {
+            if (alternative5_1(file, fi, fl)) return true;
+            if (Hidden(file[fi])) break;
+        }
+        return false;
+    }
+
+    bool alternative6_2(const Segment* file, size_t fi, size_t fl)
+    {
+        // `vendor`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "vendor", 6)) return false;
+        fi++;
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+            if (Hidden(file[fi])) return false;
+        return true;
+    }
+
+    bool alternative6_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `src`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "src", 3)) return false;
+        fi++;
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+        {
+            if (alternative6_2(file, fi, fl)) return true;
+            if (Hidden(file[fi])) break;
+        }
+        return false;
+    }
+
+    bool alternative7_2(const Segment* file, size_t fi, size_t fl)
+    {
+        // shared, see segment3
+        if (fi == fl) return false;
+        if (!segment3(file[fi].data, file[fi].length)) return false;
+        fi++;
+        return fi == fl || (fi == fl - 1 && file[fi].length == 0);
+    }
+
+    bool alternative7_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `src`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "src", 3)) return false;
+        fi++;
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+        {
+            if (alternative7_2(file, fi, fl)) return true;
+            if (Hidden(file[fi])) break;
+        }
+        return false;
+    }
+
+    bool alternative8_2(const Segment* file, size_t fi, size_t fl)
+    {
+        // shared, see segment4
+        if (fi == fl) return false;
+        if (!segment4(file[fi].data, file[fi].length)) return false;
+        fi++;
+        return fi == fl || (fi == fl - 1 && file[fi].length == 0);
+    }
+
+    bool alternative8_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `test`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "test", 4)) return false;
+        fi++;
+        // `**`
+        if (fi == fl) return false;
+        for (; fi < fl; fi++)
+        {
+            if (alternative8_2(file, fi, fl)) return true;
+            if (Hidden(file[fi])) break;
+        }
+        return false;
+    }
+
+    bool alternative9_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // `scripts`
+        if (fi == fl) return false;
+        if (!Is(file[fi], "scripts", 7)) return false;
+        fi++;
+        // shared, see segment5
+        if (fi == fl) return false;
+        if (!segment5(file[fi].data, file[fi].length)) return false;
+        fi++;
+        return fi == fl || (fi == fl - 1 && file[fi].length == 0);
+    }
+
+    bool alternative10_0(const Segment* file, size_t fi, size_t fl)
+    {
+        // shared, see segment6
+        if (fi == fl) return false;
+        if (!segment6(file[fi].data, file[fi].length)) return false;
+        fi++;
+        return fi == fl || (fi == fl - 1 && file[fi].length == 0);
+    }
+}
+
+bool IsSample(const char* path, size_t length)
+{
+    size_t count = 1;
+    for (size_t i = 0; i < length; i++) count += path[i] == '/';
+
+    Segment small[32];
+    std::unique_ptr<Segment[]> large;
+    Segment* file = small;
+    if (count > 32)
+    {
+        large.reset(new Segment[count]);
+        file = large.get();
+    }
+
+    size_t start = 0, fi = 0;
+    for (size_t i = 0; i <= length; i++)
+        if (i == length || path[i] == '/')
+        {
+            file[fi++] = Segment{ path + start, i - start };
+            start = i + 1;
+        }
+
+    // rule groups, last first
+    if (alternative0_0(file, 0, count))
+        return false;
+    if (alternative1_0(file, 0, count)
+        || alternative2_0(file, 0, count)
+        || alternative3_0(file, 0, count))
+        return true;
+    if (alternative4_0(file, 0, count)
+        || alternative5_0(file, 0, count)
+        || alternative6_0(file, 0, count))
+        return false;
+    if (alternative7_0(file, 0, count)
+        || alternative8_0(file, 0, count)
+        || alternative9_0(file, 0, count)
+        || alternative10_0(file, 0, count))
+        return true;
+    return false;
+}
+
+bool IsSample(const std::string& path)
+{
+    return IsSample(path.data(), path.length());
+}
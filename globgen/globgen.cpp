@@ -0,0 +1,49 @@
+// Compiles a rule list into a standalone C++ matcher, so fixed pattern sets can
+// be shipped without parsing globs at runtime.
+//
+//   globgen <function> <patterns> <output>
+//
+// <patterns> holds one rule per line with GlobSet semantics: later rules win
+// and a leading `!` excludes. Blank lines and lines starting with `#` are
+// skipped and surrounding whitespace is trimmed. The output defines
+//
+//   bool <function>(const char* path, size_t length);
+//   bool <function>(const std::string& path);
+//
+// Literal segments become inline compares and wildcard segments become
+// switch-based DFAs. Alternatives that only differ in their last segment share
+// one DFA for it. Segments using pattern lists or classes the DFA builder does
+// not model fall back to the regex Parse produced for them.
+#include "Generator.cpp"
+#include <fstream>
+#include <iostream>
+
+int main(int argc, char** argv)
+{
+    if (argc != 4)
+    {
+        std::cerr << "usage: globgen <function> <patterns> <output>\n";
+        return 2;
+    }
+
+    std::ifstream input(argv[2]);
+    if (!input)
+    {
+        std::cerr << "globgen: cannot read " << argv[2] << "\n";
+        return 1;
+    }
+
+    Generator generator(argv[1], Generator::Read(input));
+    std::string code = generator.Emit();
+
+    std::ofstream output(argv[3], std::ios::binary);
+    if (!(output << code))
+    {
+        std::cerr << "globgen: cannot write " << argv[3] << "\n";
+        return 1;
+    }
+
+    if (generator.Fallbacks())
+        std::cerr << "globgen: " << generator.Fallbacks() << " segment(s) fall back to std::regex\n";
+    return 0;
+}
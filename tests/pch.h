@@ -4,8 +4,16 @@
 #define _CRT_SECURE_NO_WARNINGS
 
 #include <codecvt>
+#include <fstream>
+#include <thread>
+
+#ifdef __linux__
+#include <ftw.h>
+#endif
 
 #define private public
 #include "../Match.cpp"
+#include "../Watch.cpp"
+#include "../Cache.cpp"
 #undef private
 #endif
\ No newline at end of file
@@ -1,5 +1,8 @@
 #include "pch.h"
 #include "CppUnitTest.h"
+#include "../globgen/Generator.cpp"
+// the matcher globgen emits for globgen/sample.txt
+#include "../globgen/Sample.cpp"
 
 #define Of(...) {__VA_ARGS__}
 #define LONG(str) (const wchar_t*)std::wstring_convert<std::codecvt_utf8<wchar_t>>().from_bytes(str).c_str()
@@ -44,6 +47,34 @@ inline boost::optional<std::string> Expands(std::string exp, std::vector<std::st
         expected ? Assert::Fail(LONG("\""glob"\".IsGlob != true"))   \
                  : Assert::Fail(LONG("\""glob"\".IsGlob != false"))
 
+// The GlobWatch and MatchCache tests need Linux. tests.vcxproj only builds for
+// Windows, so nothing runs them automatically; build this file on Linux with
+// stand-ins for the CppUnitTest macros to run them.
+#ifdef __linux__
+// A directory under /tmp that is removed again with everything below it.
+struct Scratch
+{
+    Scratch()
+    {
+        char name[] = "/tmp/glob-cpp.XXXXXX";
+        if (!mkdtemp(name)) throw std::runtime_error("mkdtemp failed");
+        root = name;
+    }
+
+    ~Scratch()
+    {
+        nftw(root.c_str(), [](const char* path, const struct stat*, int, FTW*) { return remove(path); },
+            16, FTW_DEPTH | FTW_PHYS);
+    }
+
+    std::string Path(const std::string& path) const { return root + "/" + path; }
+    void Dir(const std::string& path) const { mkdir(Path(path).c_str(), 0755); }
+    void File(const std::string& path) const { std::ofstream(Path(path)); }
+
+    std::string root;
+};
+#endif
+
 using namespace Microsoft::VisualStudio::CppUnitTestFramework;
 
 namespace Match
@@ -189,7 +220,438 @@ namespace Match
             ISGLOB("dir/src/abc.js", false);
             ISGLOB("dir/src/abc.*", true);
         }
+
+        TEST_METHOD(optimize)
+        {
+            Assert::AreEqual((size_t)1, Glob("{a,a}/*.js").Stats().duplicates);
+            Assert::AreEqual((size_t)1, Glob("**/**/*.js").Stats().normalized);
+            Assert::AreEqual((size_t)1, Glob("a***b*c").Stats().normalized);
+            Assert::AreEqual((size_t)0, Glob("**(a)").Stats().normalized);
+            Assert::AreEqual((size_t)1, Glob("{**/*.js,src/*.js}").Stats().subsumed);
+            Assert::AreEqual((size_t)1, Glob("{src/**,src/a/b}").Stats().subsumed);
+            Assert::AreEqual((size_t)0, Glob("{**/*.js,src/.*.js}").Stats().subsumed);
+            Assert::AreEqual((size_t)0, Glob("{src/**,src}").Stats().subsumed);
+
+            MATCH("**/**/*.js", Of("a.js", "src/a.js", "src/util/a.js"));
+            NMATCH("**/**/*.js", Of(".a.js", "src/.util/a.js"));
+            MATCH("{**/*.js,src/*.js}", Of("a.js", "src/a.js"));
+            MATCH("{src/**,src}", Of("src", "src/a"));
+            MATCH("a***b*c", Of("abc", "aXbYc"));
+            MATCH("**(a)", Of("xa", "aa"));
+        }
+
+        TEST_METHOD(prefilter)
+        {
+            auto filter = Glob::Require(Of("**", "test_*+(foo|bar).py"));
+            Assert::AreEqual((size_t)8, filter.minLength);
+            Assert::AreEqual(std::string(".py"), filter.suffix);
+            Assert::IsTrue(filter.literals == std::vector<std::string>(Of("test_")));
+
+            filter = Glob::Require(Of("src", "[ab]?\\*.c*"));
+            Assert::AreEqual((size_t)9, filter.minLength);
+            Assert::IsTrue(filter.suffix.empty());
+            Assert::IsTrue(filter.literals == std::vector<std::string>(Of("src", "*.c")));
+
+            Glob g("**/test_*+(foo|bar).py");
+            MATCH("**/test_*+(foo|bar).py", Of("test_foo.py", "a/test_xbarfoo.py", "test_foo.py/"));
+            NMATCH("**/test_*+(foo|bar).py", Of("test_foo.pyc", "a/test.py", "foo.py", "a/test_x.py"));
+            for (auto path : Of("test_foo.py", "a/test_foo.pyc", "a/best_foo.py", "t.py"))
+                g.Matches(path);
+            Assert::AreEqual((size_t)4, (size_t)g.Prefiltered().tested);
+            Assert::AreEqual((size_t)3, (size_t)g.Prefiltered().rejected);
+
+            // the `)` inside the class does not close the list
+            filter = Glob::Require(Of("@(a|[)])"));
+            Assert::AreEqual((size_t)0, filter.minLength);
+            Assert::IsTrue(filter.literals.empty());
+            MATCH("@(a|[)])", Of("a", ")"));
+            NMATCH("@(a|[)])", Of("b", "a)", "[)]"));
+        }
+
+        TEST_METHOD(literal_index)
+        {
+            Assert::AreEqual((size_t)4, Glob("**/*.{js,jsx,ts,tsx}").index.Size());
+            Assert::AreEqual((size_t)3, Glob("{Makefile,src/main.c,src/*.h}").index.Size());
+            Assert::AreEqual((size_t)0, Glob("src/*.h").index.Size());
+
+            MATCH("**/*.{js,jsx,ts,tsx}", Of("a.ts", "src/a.jsx", "src/lib/a.tsx", "a.js/"));
+            NMATCH("**/*.{js,jsx,ts,tsx}", Of(".a.ts", "src/.lib/a.ts", "a.tsc", "ts", "a.ts//"));
+            MATCH("**/{Makefile,.gitignore}", Of("Makefile", "src/.gitignore", "a/b/Makefile/"));
+            NMATCH("**/{Makefile,.gitignore}", Of(".git/Makefile", "makefile"));
+            MATCH("{Makefile,src/main.c,src/*.h,/*.c}", Of("Makefile", "src/main.c", "src/a.h", "/a.c", "src/main.c/"));
+            NMATCH("{Makefile,src/main.c,src/*.h,/*.c}", Of("a/Makefile", "src/a.c", "src/.a.h", "a.c", "src/a/b.h", "src/"));
+        }
+
+        TEST_METHOD(adapt)
+        {
+            Glob glob("src/**/*.{js,jsx,ts,tsx}");
+            glob.Adapt(8);
+            Assert::AreEqual((size_t)0, glob.adaptive->Order()[0]);
+
+            for (int i = 0; i < 8; i++) Assert::IsTrue(glob.Matches("src/lib/a.ts"));
+            Assert::AreEqual((size_t)2, glob.adaptive->Order()[0]);
+            Assert::IsTrue(glob.Matches("src/a.jsx"));
+            Assert::IsFalse(glob.Matches("src/a.tsc"));
+
+            // the literal index answers every alternative, nothing is left to order
+            Glob indexed("**/*.{js,jsx,ts,tsx}");
+            indexed.Adapt(8);
+            Assert::IsFalse((bool)indexed.adaptive);
+        }
+    };
+
+    TEST_CLASS(glob_set)
+    {
+    public:
+        TEST_METHOD(rules)
+        {
+            GlobSet set(Of("src/**/*.js", "!src/vendor/**", "src/vendor/keep.js"));
+            Assert::IsTrue(set.Matches("src/a.js"));
+            Assert::IsTrue(set.Matches("src/vendor/keep.js"));
+            Assert::IsFalse(set.Matches("src/vendor/a.js"));
+            Assert::IsFalse(set.Matches("lib/a.js"));
+        }
+
+        TEST_METHOD(optimize)
+        {
+            GlobSet set(Of("src/*.js", "**/*.js", "lib/*.js", "**/*.js", "!**/*.min.js"));
+            Assert::AreEqual((size_t)1, set.Stats().duplicates);
+            Assert::AreEqual((size_t)2, set.Stats().subsumed);
+            Assert::IsTrue(set.Matches("src/a.js"));
+            Assert::IsTrue(set.Matches("lib/a.js"));
+            Assert::IsFalse(set.Matches("lib/a.min.js"));
+        }
+
+        TEST_METHOD(adapt)
+        {
+            GlobSet set(Of("src/**/*.{js,ts}", "!src/**/gen/*.{js,ts}", "src/**/gen/keep.ts"));
+            set.Adapt(4);
+
+            for (int i = 0; i < 8; i++)
+            {
+                Assert::IsTrue(set.Matches("src/a/b.ts"));
+                Assert::IsFalse(set.Matches("src/gen/b.ts"));
+                Assert::IsTrue(set.Matches("src/gen/keep.ts"));
+            }
+
+            Assert::AreEqual((size_t)1, set.groups[0].adaptive->Order()[0]);
+            Assert::AreEqual((size_t)1, set.groups[1].adaptive->Order()[0]);
+        }
+
+        TEST_METHOD(trie)
+        {
+            GlobSet set(Of("src/*/a?.js", "src/*/b?.js", "src/lib/*.h", "src/**/*.test.?s",
+                "vendor/**/*.c?", "vendor/*/include/*.h", "docs/v[0-9]/*.md", "docs/**/index.html",
+                "!docs/v1/*.md"));
+            Assert::AreEqual((size_t)8, set.groups[0].trie.Size());
+            Assert::IsTrue(set.groups[0].sequential.empty());
+
+            Assert::IsTrue(set.Matches("src/x/a1.js"));
+            Assert::IsTrue(set.Matches("src/lib/util.h"));
+            Assert::IsTrue(set.Matches("src/a/b/c.test.ts"));
+            Assert::IsTrue(set.Matches("vendor/zlib/src/inflate.cc"));
+            Assert::IsTrue(set.Matches("vendor/zlib/include/zlib.h/"));
+            Assert::IsTrue(set.Matches("docs/v2/api.md"));
+            Assert::IsTrue(set.Matches("docs/a/b/index.html"));
+            Assert::IsFalse(set.Matches("docs/v1/api.md"));
+            Assert::IsFalse(set.Matches("src/x/c1.js"));
+            Assert::IsFalse(set.Matches("src/.x/a1.js"));
+            Assert::IsFalse(set.Matches("vendor/.git/a.cc"));
+            Assert::IsFalse(set.Matches("docs/.cache/index.html"));
+            Assert::IsFalse(set.Matches("src/lib/.h"));
+
+            // nothing to merge without a shared leading literal, prefilters do better
+            std::vector<std::string> tests, sources;
+            for (int i = 0; i < 8; i++)
+            {
+                tests.push_back("**/test" + std::to_string(i) + "_*+(foo|bar).py");
+                sources.push_back("src/**/m" + std::to_string(i) + "_*.py");
+            }
+
+            GlobSet unmerged(tests);
+            Assert::IsTrue(unmerged.groups[0].trie.Empty());
+            Assert::IsFalse(unmerged.Matches("a/b.py"));
+            Assert::AreEqual((size_t)8, (size_t)unmerged.Prefiltered().rejected);
+            Assert::IsTrue(unmerged.Matches("a/test7_foo.py"));
+
+            // wildcard segments reached by one alternative keep its prefilter
+            GlobSet merged(sources);
+            Assert::AreEqual((size_t)8, merged.groups[0].trie.Size());
+            Assert::IsFalse(merged.Matches("src/b.py"));
+            Assert::AreEqual((size_t)8, (size_t)merged.Prefiltered().rejected);
+            Assert::IsTrue(merged.Matches("src/a/m7_x.py"));
+        }
+
+        TEST_METHOD(fingerprint)
+        {
+            uint64_t rules = GlobSet(Of("src/**/*.js", "!src/vendor/**")).Fingerprint();
+            Assert::AreEqual(rules, GlobSet(Of("src/**/*.js", "!src/vendor/**")).Fingerprint());
+            Assert::AreEqual(rules, GlobSet(Of("src/**/*.js", "src/**/*.js", "!src/vendor/**")).Fingerprint());
+            Assert::AreNotEqual(rules, GlobSet(Of("src/**/*.js", "src/vendor/**")).Fingerprint());
+            Assert::AreNotEqual(rules, GlobSet(Of("!src/vendor/**", "src/**/*.js")).Fingerprint());
+        }
+
+        TEST_METHOD(parallel)
+        {
+            std::vector<std::string> patterns;
+            for (int i = 0; i < 200; i++)
+            {
+                patterns.push_back("src/m" + std::to_string(i % 50) + "/**/*.{js,ts}");
+                patterns.push_back(i % 7 ? "src/*/lib/*.js" : "!src/m" + std::to_string(i) + "/gen/**");
+            }
+
+            GlobSet serial(patterns), parallel(patterns, 4);
+            Assert::AreEqual(serial.Fingerprint(), parallel.Fingerprint());
+            Assert::AreEqual(serial.groups.size(), parallel.groups.size());
+            for (size_t g = 0; g < serial.groups.size(); g++)
+                Assert::IsTrue(serial.groups[g].parts == parallel.groups[g].parts);
+            Assert::AreEqual((size_t)serial.Stats().duplicates, (size_t)parallel.Stats().duplicates);
+            Assert::AreEqual((size_t)serial.Stats().subsumed, (size_t)parallel.Stats().subsumed);
+            Assert::IsTrue(parallel.Matches("src/m3/a/b.ts"));
+            Assert::IsFalse(parallel.Matches("src/m3/a/b.py"));
+
+            // only sets this large are eliminated on several threads
+            std::vector<std::vector<std::string>> parts;
+            for (int i = 0; i < 2000; i++)
+            {
+                std::string dir = "m" + std::to_string(i % 97);
+                parts.push_back(i % 3 ? std::vector<std::string>(Of("src", dir, "a" + std::to_string(i) + ".js"))
+                    : std::vector<std::string>(Of("src", dir, "**")));
+            }
+
+            auto serialParts = parts, parallelParts = parts;
+            std::vector<std::vector<Glob::ParseItem*>> serialSet(parts.size()), parallelSet(parts.size());
+            size_t removed = Glob::Eliminate(serialSet, serialParts);
+            Assert::AreEqual(removed, Glob::Eliminate(parallelSet, parallelParts, 4));
+            Assert::AreEqual((size_t)97, serialParts.size());
+            Assert::IsTrue(serialParts == parallelParts);
+        }
+
+        TEST_METHOD(generated)
+        {
+            // Sample.cpp is checked in, so it must be what globgen emits today
+            std::string source = __FILE__;
+            std::string dir = source.substr(0, source.find_last_of("/\\") + 1) + "../globgen/";
+            std::ifstream rules(dir + "sample.txt"), sample(dir + "Sample.cpp", std::ios::binary);
+            Assert::IsTrue(rules && sample);
+
+            std::vector<std::string> patterns = Generator::Read(rules);
+            std::string code{ std::istreambuf_iterator<char>(sample), std::istreambuf_iterator<char>() };
+            code.erase(std::remove(code.begin(), code.end(), '\r'), code.end());
+            Assert::IsTrue(Generator("IsSample", patterns).Emit() == code,
+                L"globgen/Sample.cpp is stale, run globgen IsSample sample.txt Sample.cpp");
+
+            GlobSet set(patterns);
+            std::vector<std::string> paths = FILES;
+            for (auto path : Of("src/a.js", "src/x/a1.js", "src/a/b/c.test.ts", "src/a.ts/", "src/.x/a1.js",
+                "src/a.min.js", "src/types/api.d.ts", "src/__generated__/a.ts", "src/vendor/a.js", "src/vendor/keep.js",
+                "src/lib/vendor/shim.js", "lib/a.js", "test/unit/a.ts", "test/a.tsx", "scripts/build.mjs",
+                "scripts/a/build.mjs", "vite.config.ts", ".eslintrc.config.js", "package.json", "src/package.json",
+                "Makefile", "docs/api.md", "docs/zeta.md", "docs/v2/api.md", "test_foo.py", "a/test_xbarfoo.py",
+                "a/test_x.py", "test_foo.pyc", "node_modules/x/src/a.js", "x/node_modules/a.js", ""))
+                paths.push_back(path);
+
+            for (auto& path : paths)
+                if (IsSample(path) != set.Matches(path))
+                    Assert::Fail(LONG("IsSample and GlobSet disagree on \"" + path + "\""));
+        }
+
+        TEST_METHOD(may_match_below)
+        {
+            GlobSet set(Of("src/**/*.js", "docs/*.md", "!node_modules/**"));
+            Assert::IsTrue(set.MayMatchBelow(""));
+            Assert::IsTrue(set.MayMatchBelow("src"));
+            Assert::IsTrue(set.MayMatchBelow("src/lib/util"));
+            Assert::IsTrue(set.MayMatchBelow("docs"));
+            Assert::IsFalse(set.MayMatchBelow("docs/api"));
+            Assert::IsFalse(set.MayMatchBelow("src/.cache"));
+            Assert::IsFalse(set.MayMatchBelow("node_modules"));
+        }
+    };
+
+    TEST_CLASS(path_view)
+    {
+    public:
+        TEST_METHOD(tokenize)
+        {
+            PathView view("src/.lib/index.test.js");
+            Assert::AreEqual((size_t)3, view.parts.size());
+            Assert::AreEqual((size_t)4, view.offsets[1]);
+            Assert::AreEqual((size_t)1, view.firstHidden);
+            Assert::AreEqual((size_t)2, view.name);
+            Assert::AreEqual(view.path.length(), view.end);
+            Assert::AreEqual(PathView::Hash("index.test.js"), view.hashes[2]);
+            Assert::AreEqual(PathView::Hash(".lib"), view.hashes[1]);
+            Assert::AreEqual(PathView::Hash("src/.lib/"), view.Hash(0, 9));
+            Assert::AreEqual(PathView::Hash(".test.js"), view.Hash(view.path.length() - 8, view.path.length()));
+            Assert::AreEqual(PathView::Hash(""), view.Hash(4, 4));
+
+            PathView dir("src/.lib/");
+            Assert::AreEqual((size_t)1, dir.name);
+            Assert::AreEqual((size_t)8, dir.end);
+            Assert::AreEqual(PathView::Hash(""), dir.hashes[2]);
+        }
+
+        TEST_METHOD(shared)
+        {
+            PathView view("src/lib/a.ts");
+            Assert::IsTrue(Glob("**/*.{js,ts}").Matches(view));
+            Assert::IsTrue(Glob("src/**").Matches(view));
+            Assert::IsFalse(Glob("*.ts").Matches(view));
+            Assert::IsTrue(GlobSet(Of("src/**", "!**/*.js")).Matches(view));
+        }
+    };
+
+    TEST_CLASS(published)
+    {
+    public:
+        TEST_METHOD(swap)
+        {
+            Published<GlobSet> rules(std::unique_ptr<GlobSet>(new GlobSet(Of("**/*.js"))));
+            Assert::IsTrue(rules.Matches("src/a.js"));
+
+            rules.Publish(std::unique_ptr<GlobSet>(new GlobSet(Of("**/*.ts"))));
+            Assert::IsFalse(rules.Matches("src/a.js"));
+            Assert::IsTrue(rules.Matches(PathView("src/a.ts")));
+        }
+
+        TEST_METHOD(reclaim)
+        {
+            Published<GlobSet> rules(std::unique_ptr<GlobSet>(new GlobSet(Of("*.js"))));
+            {
+                auto before = rules.Read();
+                Assert::AreEqual((size_t)1, rules.Publish(std::unique_ptr<GlobSet>(new GlobSet(Of("*.ts")))));
+                Assert::IsTrue(before->Matches("a.js"));
+
+                // a nested read does not hold back what it replaced
+                auto after = rules.Read();
+                Assert::IsTrue(after->Matches("a.ts"));
+                Assert::AreEqual((size_t)1, rules.Reclaim());
+            }
+            Assert::AreEqual((size_t)0, rules.Reclaim());
+        }
+
+        TEST_METHOD(concurrent)
+        {
+            Published<GlobSet> rules(std::unique_ptr<GlobSet>(new GlobSet(Of("*.js"))));
+            std::atomic<bool> done{ false };
+            std::atomic<size_t> torn{ 0 };
+
+            std::vector<std::thread> readers;
+            for (int i = 0; i < 4; i++)
+                readers.emplace_back([&]
+                {
+                    while (!done)
+                    {
+                        auto rule = rules.Read();
+                        if (rule->Matches("a.js") == rule->Matches("a.ts")) ++torn;
+                    }
+                });
+
+            for (int i = 0; i < 200; i++)
+                rules.Publish(std::unique_ptr<GlobSet>(new GlobSet(Of(i % 2 ? "*.js" : "*.ts"))));
+
+            done = true;
+            for (auto& reader : readers) reader.join();
+            Assert::AreEqual((size_t)0, torn.load());
+            Assert::AreEqual((size_t)0, rules.Reclaim());
+        }
+    };
+
+#ifdef __linux__
+    TEST_CLASS(glob_watch)
+    {
+    public:
+        TEST_METHOD(rename)
+        {
+            Scratch tree;
+            tree.Dir("zdir");
+            tree.Dir("zdir/sub");
+            tree.File("zdir/x.js");
+            tree.File("zdir/sub/s.js");
+
+            GlobWatch watch(tree.root, Of("**/*.js"));
+            Assert::AreEqual((size_t)2, watch.Matched().size());
+
+            // the new name sorts before the old one, so it is scanned while
+            // the directory's watches are still registered under the old name
+            Assert::AreEqual(0, std::rename(tree.Path("zdir").c_str(), tree.Path("adir").c_str()));
+            auto changes = watch.Poll(1000);
+            Assert::IsTrue(changes.added == std::vector<std::string>(Of("adir/sub/s.js", "adir/x.js")));
+            Assert::IsTrue(changes.removed == std::vector<std::string>(Of("zdir/sub/s.js", "zdir/x.js")));
+            Assert::AreEqual((size_t)3, watch.dirs.size());
+            Assert::AreEqual((size_t)3, watch.watches.size());
+
+            tree.File("adir/y.js");
+            tree.File("adir/sub/t.js");
+            changes = watch.Poll(1000);
+            Assert::IsTrue(changes.added == std::vector<std::string>(Of("adir/sub/t.js", "adir/y.js")));
+        }
+    };
+
+    TEST_CLASS(match_cache)
+    {
+    public:
+        TEST_METHOD(walk)
+        {
+            Scratch tree, store;
+            for (auto dir : Of("docs", "src", "src/lib")) tree.Dir(dir);
+            for (auto file : Of("docs/d.md", "src/a.js", "src/c.txt", "src/lib/b.js")) tree.File(file);
+
+            // the ctime cannot be set back, so let the tree settle instead
+            const unsigned settle = 200;
+            std::this_thread::sleep_for(std::chrono::milliseconds(settle + 50));
+
+            std::string file = store.Path("matches");
+            {
+                MatchCache cache(file, Of("**/*.js"), settle);
+                Assert::IsTrue(cache.Walk(tree.root) == std::vector<std::string>(Of("src/a.js", "src/lib/b.js")));
+                Assert::AreEqual((size_t)4, cache.Stats().scanned);
+                cache.Save();
+            }
+
+            MatchCache cache(file, Of("**/*.js"), settle);
+            Assert::IsTrue(cache.Walk(tree.root) == std::vector<std::string>(Of("src/a.js", "src/lib/b.js")));
+            Assert::AreEqual((size_t)4, cache.Stats().reused);
+            Assert::AreEqual((size_t)0, cache.Stats().scanned);
+
+            // adding an entry changes the mtime of its directory
+            tree.File("src/e.js");
+            Assert::IsTrue(cache.Walk(tree.root) == std::vector<std::string>(Of("src/a.js", "src/e.js", "src/lib/b.js")));
+            Assert::AreEqual((size_t)3, cache.Stats().reused);
+            Assert::AreEqual((size_t)1, cache.Stats().scanned);
+
+            // too recent to tell a later change apart, so it is not saved
+            cache.Save();
+            cache.Walk(tree.root);
+            Assert::AreEqual((size_t)1, cache.Stats().scanned);
+
+            std::vector<std::pair<std::string, bool>> entries;
+            Tree{ store.root }.List("", entries);
+            Assert::AreEqual((size_t)1, entries.size());
+
+            // a cache saved for other rules is ignored
+            MatchCache other(file, Of("**/*.md"), settle);
+            Assert::IsTrue(other.Walk(tree.root) == std::vector<std::string>(Of("docs/d.md")));
+            Assert::AreEqual((size_t)0, other.Stats().reused);
+
+            std::this_thread::sleep_for(std::chrono::milliseconds(settle + 50));
+            cache.Walk(tree.root);
+            cache.Save();
+
+            // a rename keeps the entry count, and with the mtime set back only
+            // the ctime shows the change
+            struct stat st;
+            lstat(tree.Path("docs").c_str(), &st);
+            std::rename(tree.Path("docs/d.md").c_str(), tree.Path("docs/d.js").c_str());
+            timespec times[2] = { st.st_atim, st.st_mtim };
+            utimensat(AT_FDCWD, tree.Path("docs").c_str(), times, AT_SYMLINK_NOFOLLOW);
+            Assert::IsTrue(cache.Walk(tree.root)
+                == std::vector<std::string>(Of("docs/d.js", "src/a.js", "src/e.js", "src/lib/b.js")));
+            Assert::AreEqual((size_t)1, cache.Stats().scanned);
+        }
     };
+#endif
 
     TEST_CLASS(brace_expansion)
     {